@@ -0,0 +1,59 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <NeuralNetwork.hpp>
+#include <Dataset.hpp>
+#include <DecisionCache.hpp>
+#include <Match.hpp>
+#include <ObservationNormalizer.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * One AI bat's decision per match tick: turns a published MatchSnapshot into a bat velocity. AIBat runs it on its
+   * activation thread and the allocation test runs it against a HeadlessMatch, so both exercise the same work.
+   * network is only dereferenced under networkMutex, since a policy-gradient update may swap it. A supervised
+   * network backpropagates the hand-made labels of every decision it infers; a policy network samples its outputs
+   * and holds each action for policyDecisionInterval ticks. networkAllocations counts what zeuron allocated inside
+   * feedforward and backpropagate, which pong does not control.
+   */
+  struct AIController
+  {
+    std::shared_ptr<zeuron::NeuralNetwork> &network;
+    std::mutex &networkMutex;
+    ObservationNormalizer &normalizer;
+    std::atomic<unsigned long long> &networkGeneration;
+    bool leftSide = true;
+    float batX = 0;
+    int batHeight = 0;
+    bool policyNetwork = false;
+    // called under networkMutex after every inference
+    std::function<void(zeuron::NeuralNetwork &)> onInference;
+    std::unique_ptr<DatasetRecorder> datasetRecorder;
+    std::vector<long double> input;
+    std::vector<long double> expectedOutputs;
+    DecisionCache decisionCache;
+    std::array<long double, 2> decisionOutputs{};
+    std::array<long double, 2> sampledActions{};
+    std::mt19937 random;
+    unsigned long long inferenceCount = 0;
+    unsigned long long networkAllocations = 0;
+    unsigned long long nextDecisionTick = 0;
+    unsigned char lastLeftScore = 0;
+    unsigned char lastRightScore = 0;
+    float velocityY = 0;
+    AIController(std::shared_ptr<zeuron::NeuralNetwork> &sharedNetwork, std::mutex &sharedNetworkMutex,
+                 ObservationNormalizer &sharedNormalizer, std::atomic<unsigned long long> &sharedGeneration,
+                 const DecisionCache::Mode &cacheMode, const unsigned long &seed);
+    float decide(const MatchSnapshot &snapshot);
+    float applyOutputs();
+  };
+}
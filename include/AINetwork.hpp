@@ -0,0 +1,43 @@
+/*
+ */
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <NeuralNetwork.hpp>
+#include <ObservationNormalizer.hpp>
+/*
+ */
+namespace pong
+{
+  std::pair<std::shared_ptr<char>, unsigned long> readFileToBuffer(const std::string &filename);
+  void writeBufferToFile(const char *buffer, unsigned long size, const std::string &filename);
+  /*
+   * How a network was last trained, persisted in pong.nrl. Supervised networks follow the hand-made up/down labels
+   * and keep learning from them in game; policy networks come from PolicyGradientTrainer and are only sampled.
+   */
+  enum AINetworkTraining : uint32_t
+  {
+    SupervisedTraining,
+    PolicyGradientTraining
+  };
+  std::shared_ptr<zeuron::NeuralNetwork> createAINetwork();
+  /*
+   * Loads the network, how it was trained and its observation statistics from a pong.nrl file, or creates a fresh
+   * supervised network (leaving the normalizer untouched) when the file is missing or unreadable
+   */
+  std::shared_ptr<zeuron::NeuralNetwork> loadOrCreateAINetwork(const std::string &filename,
+                                                               ObservationNormalizer &normalizer,
+                                                               AINetworkTraining &training);
+  void saveAINetwork(zeuron::NeuralNetwork &network, const ObservationNormalizer &normalizer,
+                     const AINetworkTraining &training, const std::string &filename);
+  /*
+   * The normalizer mode is a command line choice, warns when it differs from the one filename was saved with
+   */
+  void warnOnScalingChange(const ObservationNormalizer &normalizer, const std::string &filename);
+  /*
+   * A private replica from bytes produced by NeuralNetwork::serialize(), for threads that only run inference
+   */
+  std::shared_ptr<zeuron::NeuralNetwork> copyAINetwork(const char *bytes, const unsigned long &size);
+}
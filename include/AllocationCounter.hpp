@@ -0,0 +1,23 @@
+/*
+ */
+#pragma once
+/*
+ */
+namespace pong
+{
+  /*
+   * Global operator new is replaced in AllocationCounter.cpp to count every heap allocation, per process and per
+   * thread. Tests and benchmarks take an AllocationScope around steady-state work and assert the delta is zero.
+   */
+  unsigned long long processAllocationCount();
+  unsigned long long threadAllocationCount();
+  struct AllocationScope
+  {
+    unsigned long long processStart;
+    unsigned long long threadStart;
+    AllocationScope();
+    unsigned long long processAllocations() const;
+    unsigned long long threadAllocations() const;
+    void reset();
+  };
+}
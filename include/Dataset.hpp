@@ -0,0 +1,111 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <ObservationNormalizer.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * Training dataset file (.pds):
+   *   header: "PDS1", uint32 version, uint32 observationWidth, uint32 expectedWidth
+   *   chunks: "CHNK", uint32 recordsSize, then columns: observationWidth x float[recordsSize],
+   *           expectedWidth x float[recordsSize], int8 outcome[recordsSize], zero padding to 4 bytes
+   * Observations are raw (before normalization). Outcome is +1 when the recording bat's side won the rally the
+   * record belongs to, -1 when it lost and 0 when unknown (the rally outlived the chunk or the match ended).
+   */
+  struct DatasetFormat
+  {
+    static constexpr char magic[4] = {'P', 'D', 'S', '1'};
+    static constexpr char chunkMagic[4] = {'C', 'H', 'N', 'K'};
+    static constexpr uint32_t version = 1;
+    static constexpr unsigned long observationWidth = ObservationNormalizer::inputsSize;
+    static constexpr unsigned long expectedWidth = 2;
+    static constexpr unsigned long headerSize = 16;
+    static constexpr unsigned long chunkHeaderSize = 8;
+    static unsigned long chunkSize(const unsigned long &recordsSize);
+  };
+  struct DatasetChunk
+  {
+    static constexpr unsigned long capacity = 4096;
+    unsigned long size = 0;
+    std::array<std::array<float, capacity>, DatasetFormat::observationWidth> observations;
+    std::array<std::array<float, capacity>, DatasetFormat::expectedWidth> expectedOutputs;
+    std::array<int8_t, capacity> outcomes;
+  };
+  /*
+   * Streams chunks to disk on a background thread. The chunk pool is fixed at construction, so recording never
+   * allocates and never blocks the AI: when every chunk is queued, acquire() fails and the records are dropped.
+   */
+  struct DatasetWriter
+  {
+    std::ofstream file;
+    std::mutex chunksMutex;
+    std::condition_variable chunksCondition;
+    std::vector<std::unique_ptr<DatasetChunk>> freeChunks;
+    std::vector<std::unique_ptr<DatasetChunk>> fullChunks;
+    std::vector<std::unique_ptr<DatasetChunk>> writingChunks;
+    std::atomic<unsigned long long> droppedRecords = 0;
+    std::atomic<unsigned long long> writtenRecords = 0;
+    bool open = true;
+    std::thread writerThread;
+    DatasetWriter(const std::string &filename, const unsigned long &poolSize = 8);
+    ~DatasetWriter();
+    void close();
+    std::unique_ptr<DatasetChunk> acquire();
+    void submit(std::unique_ptr<DatasetChunk> chunk);
+    void run();
+  };
+  /*
+   * Per-producer (one per AIBat) open chunk. Records of the current rally are held in the open chunk so their
+   * outcome can be stamped by endRally() before the chunk is handed to the writer. Holds the writer alive until
+   * its last chunk is submitted.
+   */
+  struct DatasetRecorder
+  {
+    std::shared_ptr<DatasetWriter> writer;
+    std::unique_ptr<DatasetChunk> chunk;
+    unsigned long rallyStart = 0;
+    DatasetRecorder(const std::shared_ptr<DatasetWriter> &writer);
+    ~DatasetRecorder();
+    void record(const std::vector<long double> &observation, const std::vector<long double> &expectedOutput);
+    void endRally(const int8_t &outcome);
+    void flush();
+  };
+  /*
+   * Read-only memory map of a dataset file; chunk views point straight into the mapping
+   */
+  struct DatasetChunkView
+  {
+    unsigned long size;
+    std::array<const float *, DatasetFormat::observationWidth> observations;
+    std::array<const float *, DatasetFormat::expectedWidth> expectedOutputs;
+    const int8_t *outcomes;
+  };
+  struct MappedDataset
+  {
+    const char *data = nullptr;
+    unsigned long size = 0;
+#if defined(_WIN32)
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+    std::vector<DatasetChunkView> chunks;
+    unsigned long long recordsSize = 0;
+    MappedDataset(const std::string &filename);
+    ~MappedDataset();
+    MappedDataset(const MappedDataset &) = delete;
+    MappedDataset &operator=(const MappedDataset &) = delete;
+    void unmap();
+  };
+}
@@ -0,0 +1,49 @@
+/*
+ */
+#pragma once
+#include <array>
+/*
+ */
+namespace pong
+{
+  /*
+   * Remembers AI decisions by a quantized observation (predicted hit point, bat y, ball position, ball velocity)
+   * and the supervised label, so the AI loop can skip the forward pass, and for a supervised network the backward
+   * pass, while nothing it cares about has changed. The distance to the ball is left out since it follows from the
+   * ball position and bat y; keying on the label means a hit never reuses outputs learned for a different target.
+   * Entries computed more than maxAge network updates ago are treated as misses so the cache follows training.
+   * Skipped backward passes mean fewer (near-duplicate) training samples; --decision-cache=off trains on every tick.
+   */
+  struct DecisionCache
+  {
+    enum Mode
+    {
+      Off,
+      Cache,
+      OnChange
+    };
+    struct Entry
+    {
+      unsigned long long key = 0;
+      unsigned long long generation = 0;
+      bool valid = false;
+      std::array<long double, 2> outputs;
+    };
+    static constexpr unsigned long capacity = 4096;
+    static constexpr int bucketSize = 8;
+    Mode mode;
+    unsigned long long maxAge;
+    std::array<Entry, capacity> entries;
+    Entry lastEntry;
+    unsigned long long lookups = 0;
+    unsigned long long hits = 0;
+    DecisionCache(const Mode &mode, const unsigned long long &maxAge = 1024);
+    static unsigned long long makeKey(const float &hitPointX, const float &hitPointY, const float &batY,
+                                      const float &ballX, const float &ballY, const float &velocityX,
+                                      const float &velocityY, const unsigned int &label);
+    bool lookup(const unsigned long long &key, const unsigned long long &generation,
+                std::array<long double, 2> &outputs);
+    void store(const unsigned long long &key, const unsigned long long &generation,
+               const std::array<long double, 2> &outputs);
+  };
+}
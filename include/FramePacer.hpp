@@ -0,0 +1,41 @@
+/*
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+/*
+ */
+namespace pong
+{
+  /*
+   * Holds the render loop to a target frame rate. Sleeps until just before the deadline and spins only for the
+   * last spinMargin, so pacing is precise without burning a core. While idle-eligible (a static menu) and no
+   * input has arrived for idleDelay it drops to idleFPS. setIdleEligible and wake may be called from any thread.
+   * The game steps its simulation once per rendered frame, so targetFPS also sets ball speed and Train AI
+   * throughput; 60 is the speed the game was tuned for.
+   */
+  struct FramePacer
+  {
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::chrono::microseconds spinMargin{500};
+    static constexpr std::chrono::milliseconds idleDelay{500};
+    static constexpr std::chrono::seconds reportPeriod{1};
+    int targetFPS;
+    int idleFPS;
+    std::atomic<bool> idleEligible = false;
+    bool idle = false;
+    Clock::time_point nextFrame;
+    std::atomic<Clock::time_point> lastWake;
+    Clock::time_point reportStart;
+    double reportCPUStart;
+    unsigned long reportFrames = 0;
+    double achievedFPS = 0;
+    double cpuPercent = 0;
+    FramePacer(const int &targetFPS, const int &idleFPS);
+    void pace();
+    void wake();
+    void setIdleEligible(const bool &eligible);
+    bool updateStats();
+    static double processCPUSeconds();
+  };
+}
@@ -0,0 +1,107 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <random>
+#include <vector>
+#include <Seqlock.hpp>
+/*
+ */
+namespace pong
+{
+  struct Point
+  {
+    float x;
+    float y;
+  };
+  struct Bounce
+  {
+    Point start;
+    Point end;
+  };
+  struct PlayArea
+  {
+    float x;
+    float y;
+    float width;
+    float height;
+  };
+  /*
+   * Everything an AI observes about a match, published once per tick by whoever simulates it
+   */
+  struct MatchSnapshot
+  {
+    unsigned long long tick;
+    float ballX;
+    float ballY;
+    float ballVelocityX;
+    float ballVelocityY;
+    Point hitPoint;
+    float leftBatY;
+    float rightBatY;
+    unsigned char leftScore;
+    unsigned char rightScore;
+  };
+  /*
+   * The rules of a match, shared by the rendered entities and HeadlessMatch so both play the same game
+   */
+  enum BallEvent
+  {
+    BallMoved,
+    WallBounced,
+    LeftBatHit,
+    RightBatHit,
+    LeftScored,
+    RightScored
+  };
+  void serveBall(std::mt19937 &random, float &velocityX, float &velocityY);
+  void stepBat(float &y, const float &velocityY, const int &height, const int &windowHeight);
+  BallEvent stepBall(float &x, float &y, float &velocityX, float &velocityY, const float &leftBatY,
+                     const float &leftBatVelocityY, const float &rightBatY, const float &rightBatVelocityY,
+                     const int &batHeight, const int &windowWidth, const int &windowHeight);
+  void calculateTrajectory(const Point &position, const Point &velocity, const PlayArea &playArea,
+                           std::vector<Bounce> &bounces, Point &hitPoint);
+  /*
+   * Fills the raw (unnormalized) network input for one bat, see ObservationNormalizer for the layout
+   */
+  void observeMatch(const MatchSnapshot &snapshot, const bool &leftSide, const float &batX, const int &batHeight,
+                    std::vector<long double> &input);
+  /*
+   * The supervised labels for one bat: press up (index 0) or down (index 1) to move towards the predicted hit point
+   * when the ball is heading for its side, neither otherwise. Returns them packed as up + 2 * down.
+   */
+  unsigned int labelMatch(const MatchSnapshot &snapshot, const bool &leftSide,
+                          std::vector<long double> &expectedOutputs);
+  /*
+   * How a policy-trained network plays, shared by PolicyGradientTrainer's rollouts and AIBat so the game runs the
+   * policy that was trained: the two sigmoid outputs are independent Bernoulli policies for the up and down keys,
+   * up wins when both are sampled, and each decision is held for policyDecisionInterval ticks.
+   */
+  constexpr unsigned long policyDecisionInterval = 4;
+  float samplePolicyAction(const long double &upProbability, const long double &downProbability,
+                           std::mt19937 &random, std::array<long double, 2> &actions);
+  /*
+   * A match without a window or entities, stepped as fast as the caller likes. The bats are driven by setting
+   * their velocities before each step(). With publishSnapshots set, every step also stores the state in snapshot
+   * for observers on other threads.
+   */
+  struct HeadlessMatch
+  {
+    int windowWidth;
+    int windowHeight;
+    int batHeight;
+    float leftBatX;
+    float rightBatX;
+    PlayArea playArea;
+    MatchSnapshot state{};
+    float leftBatVelocityY = 0;
+    float rightBatVelocityY = 0;
+    std::vector<Bounce> bounces;
+    std::mt19937 random;
+    bool publishSnapshots = false;
+    Seqlock<MatchSnapshot> snapshot;
+    HeadlessMatch(const int &windowWidth, const int &windowHeight, const unsigned long &seed);
+    void serve();
+    BallEvent step();
+  };
+}
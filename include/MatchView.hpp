@@ -0,0 +1,20 @@
+/*
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <anex/modules/fenster/Fenster.hpp>
+#include <Match.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * What Board, Bat and Ball draw each frame, kept apart from the entities so the allocation test can draw a
+   * HeadlessMatch into an off-screen fenster and check that a frame does not allocate
+   */
+  void drawBoard(::fenster *f, const int &windowWidth, const int &windowHeight, const unsigned char &leftScore,
+                 const unsigned char &rightScore);
+  void drawBat(::fenster *f, const float &x, const float &y, const int &height, const uint32_t &color);
+  void drawBall(::fenster *f, const float &x, const float &y, const int &radius, const std::vector<Bounce> &bounces);
+}
@@ -0,0 +1,50 @@
+/*
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <NeuralNetwork.hpp>
+#include <anex/modules/fenster/Fenster.hpp>
+/*
+ */
+namespace pong
+{
+  using WeightsSnapshot = std::vector<std::vector<std::vector<long double>>>;
+  /*
+   * Draws the network in its own window on its own thread. Trainers hand it weights through publish(), which
+   * is rate limited to the refresh rate and never blocks, so the visualizer never touches aiNetworkMutex.
+   */
+  struct NetworkVisualizer
+  {
+    int width;
+    int height;
+    int refreshRate;
+    long double threshold;
+    std::chrono::steady_clock::duration refreshPeriod;
+    std::atomic<std::chrono::steady_clock::rep> lastPublishTicks = 0;
+    std::mutex snapshotMutex;
+    WeightsSnapshot publishedWeights;
+    bool snapshotDirty = false;
+    WeightsSnapshot frontWeights;
+    WeightsSnapshot drawnWeights;
+    std::vector<uint32_t> pixels;
+    std::atomic<bool> open = true;
+    std::thread visualizerThread;
+    NetworkVisualizer(const zeuron::NeuralNetwork &network,
+                      const int &width,
+                      const int &height,
+                      const int &refreshRate = 15,
+                      const long double &threshold = 0.001);
+    ~NetworkVisualizer();
+    void publish(const zeuron::NeuralNetwork &network);
+    void run();
+    void drawConnection(::fenster &f, const unsigned long &layerIndex, const unsigned long &neuronIndex,
+                        const unsigned long &inputIndex, const long double &weight);
+    void drawNeuron(::fenster &f, const unsigned long &columnIndex, const unsigned long &neuronIndex);
+    std::pair<int, int> neuronPosition(const unsigned long &columnIndex, const unsigned long &neuronIndex);
+    unsigned long columnSize(const unsigned long &columnIndex);
+  };
+}
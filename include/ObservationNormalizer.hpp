@@ -0,0 +1,41 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+/*
+ */
+namespace pong
+{
+  /*
+   * Maps the raw AI observation (pixel positions, velocities, side flag) onto roughly unit scale before it reaches
+   * the network. PlayAreaScaling uses fixed window-relative ranges, RunningStatistics whitens with a running
+   * mean/variance (Welford) that is persisted in pong.nrl next to the weights. The mode itself comes from the
+   * command line; storedMode is only the one the loaded file was saved with.
+   */
+  struct ObservationNormalizer
+  {
+    enum Mode
+    {
+      PlayAreaScaling,
+      RunningStatistics
+    };
+    static constexpr unsigned long inputsSize = 9;
+    static constexpr long double clampLimit = 5;
+    Mode mode;
+    Mode storedMode;
+    std::array<long double, inputsSize> offsets;
+    std::array<long double, inputsSize> scales;
+    unsigned long long count = 0;
+    std::array<long double, inputsSize> means{};
+    std::array<long double, inputsSize> m2s{};
+    ObservationNormalizer(const Mode &mode, const float &windowWidth, const float &windowHeight);
+    void clearStatistics();
+    void update(const std::vector<long double> &input);
+    void merge(const ObservationNormalizer &other);
+    void normalize(std::vector<long double> &input) const;
+    void serialize(std::string &bytes) const;
+    bool deserialize(const char *bytes, const unsigned long &size);
+  };
+}
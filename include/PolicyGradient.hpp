@@ -0,0 +1,93 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <NeuralNetwork.hpp>
+#include <Match.hpp>
+#include <ObservationNormalizer.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * One decision of one bat, with the keys samplePolicyAction drew from the network's two outputs
+   */
+  struct PolicyStep
+  {
+    std::array<long double, ObservationNormalizer::inputsSize> observation;
+    std::array<long double, 2> actions;
+    long double reward;
+  };
+  struct PolicyGradientSettings
+  {
+    unsigned long matchesSize = 16;
+    unsigned long threadsSize = 4;
+    unsigned long ticksPerBatch = 2048;
+    // each sampled action is held for this many ticks, which shortens the credit assignment horizon; the game
+    // always plays with policyDecisionInterval
+    unsigned long decisionInterval = policyDecisionInterval;
+    long double discount = 0.99;
+    long double scoreReward = 1;
+    long double hitReward = 0.25;
+    // backpropagate only applies one sample at a time, so a batch is thousands of small steps rather than one
+    long double advantageScale = 0.05;
+    // a rally longer than this (two unbeatable bats) is cut off and scored as a draw
+    unsigned long maxRallySteps = 8192;
+    // have every match publish its state each tick, for a live view of the rollouts
+    bool publishSnapshots = false;
+  };
+  struct PolicyBatchStats
+  {
+    unsigned long long steps = 0;
+    unsigned long long rallies = 0;
+    unsigned long long hits = 0;
+    long double meanReturn = 0;
+  };
+  /*
+   * REINFORCE with a batch-normalized return baseline. Rollouts run on settings.threadsSize threads, each against
+   * its own replica of the network and its own share of the headless matches, so they never touch networkMutex.
+   * Completed rallies are then applied in one shuffled pass to a fresh replica of the network the rollouts sampled
+   * from, which replaces the shared network under networkMutex, so the lock is only held for the swap. Readers have
+   * to dereference network under the lock each time. Backpropagating towards p + advantageScale * A * (a - p) moves
+   * each output along the policy gradient (a - p) of its sampled key. Rallies still running when a batch ends
+   * carry over into the next one.
+   */
+  struct PolicyGradientTrainer
+  {
+    struct Worker
+    {
+      ObservationNormalizer statistics;
+      std::vector<PolicyStep> steps;
+      unsigned long long rallies = 0;
+      unsigned long long hits = 0;
+      long double returnsSum = 0;
+      long double returnsSquaresSum = 0;
+      Worker(const ObservationNormalizer &statistics);
+    };
+    PolicyGradientSettings settings;
+    std::shared_ptr<zeuron::NeuralNetwork> &network;
+    std::mutex &networkMutex;
+    ObservationNormalizer &normalizer;
+    std::vector<std::unique_ptr<HeadlessMatch>> matches;
+    std::vector<std::array<std::vector<PolicyStep>, 2>> rallySteps;
+    std::vector<Worker> workers;
+    std::vector<const PolicyStep *> updateOrder;
+    std::mt19937 random;
+    unsigned long long batches = 0;
+    // set from another thread to make runBatch() return early without updating the network
+    std::atomic<bool> stopping = false;
+    PolicyGradientTrainer(std::shared_ptr<zeuron::NeuralNetwork> &network, std::mutex &networkMutex,
+                          ObservationNormalizer &normalizer, const PolicyGradientSettings &settings);
+    PolicyBatchStats runBatch();
+    void rollout(const unsigned long &workerIndex, const char *networkBytes, const unsigned long &networkSize,
+                 const ObservationNormalizer &frozenNormalizer);
+    void endRally(Worker &worker, std::vector<PolicyStep> &steps);
+    void update(const long double &meanReturn, const long double &returnDeviation, const char *networkBytes,
+                const unsigned long &networkSize);
+  };
+}
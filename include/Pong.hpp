@@ -8,6 +8,15 @@
 #include <map>
 #include <functional>
 #include <anex/modules/fenster/Fenster.hpp>
+#include <AIController.hpp>
+#include <AllocationCounter.hpp>
+#include <Trace.hpp>
+#include <DecisionCache.hpp>
+#include <Seqlock.hpp>
+#include <FramePacer.hpp>
+#include <Dataset.hpp>
+#include <Match.hpp>
+#include <atomic>
 /*
  */
 namespace pong
@@ -40,11 +49,24 @@ namespace pong
                  const std::function<void()> &onEnter);
     void render() override;
   };
+  /*
+   * Added first to every scene so its render marks the start of each frame
+   */
+  struct FrameEntity : anex::IEntity
+  {
+    FrameEntity(anex::IGame &game);
+    void render() override;
+  };
   struct PongGame : FensterGame
   {
     unsigned int escKeyId = 0;
-    PongGame(const int &windowWidth, const int &windowHeight);
+    unsigned long long frameStart = 0;
+    FramePacer framePacer;
+    bool reportFrameStats;
+    PongGame(const int &windowWidth, const int &windowHeight, const int &targetFPS = 60, const int &idleFPS = 10,
+             const bool &reportFrameStats = false);
     void onEscape(const bool &pressed);
+    void onFrame();
   };
   struct MainMenuScene : anex::IScene
   {
@@ -55,6 +77,7 @@ namespace pong
     unsigned int enterKeyId = 0;
     std::shared_ptr<ButtonEntity> playerVsAIButton;
     std::shared_ptr<ButtonEntity> trainAIButton;
+    std::shared_ptr<ButtonEntity> tiledTrainAIButton;
     std::shared_ptr<ButtonEntity> playerVsPlayerButton;
     std::shared_ptr<ButtonEntity> exitButton;
     std::vector<std::shared_ptr<ButtonEntity>> buttonsList;
@@ -66,6 +89,7 @@ namespace pong
     void onEnterKey(const bool &pressed);
     void onPlayerVsAIEnter();
     void onTrainAIEnter();
+    void onTiledTrainAIEnter();
     void onPlayerVsPlayerEnter();
     void onExitEnter();
   };
@@ -80,22 +104,12 @@ namespace pong
     float y;
     int height;
     Side side;
-    float velocityY = 0;
+    std::atomic<float> velocityY = 0;
     Bat(anex::IGame &game, const Bat::Side &side);
     void render() override;
     void onUpKey(const bool &pressed);
     void onDownKey(const bool &pressed);
   };
-  struct Point
-  {
-    float x;
-    float y;
-  };
-  struct Bounce
-  {
-    Point start;
-    Point end;
-  };
   struct Ball : anex::IEntity
   {
     PongScene &pongScene;
@@ -106,18 +120,12 @@ namespace pong
     float velocityY;
     PongScene *pongScenePointer = 0;
     std::pair<std::vector<Bounce>, Point> trajectory;
+    std::vector<Bounce> bouncesScratch;
     Ball(anex::IGame &game, PongScene &pongScene, const int &radius);
     void startMoving();
     void render() override;
     void reset();
-    std::pair<std::vector<Bounce>, Point> calculateTrajectory();
-  };
-  struct PlayArea
-  {
-    float x;
-    float y;
-    float width;
-    float height;
+    void calculateTrajectory(std::vector<Bounce> &bounces, Point &hitPoint);
   };
   struct Board : anex::IEntity
   {
@@ -127,6 +135,7 @@ namespace pong
     float boardWidth;
     float boardHeight;
     PlayArea playArea;
+    AllocationScope frameAllocationScope;
     Board(anex::IGame &game, PongScene &pongScene);
     void render() override;
     PlayArea& getPlayArea();
@@ -146,6 +155,7 @@ namespace pong
   };
   struct PongScene : anex::IScene
   {
+    std::shared_ptr<FrameEntity> frameEntity;
     std::shared_ptr<Bat> leftBat;
     std::shared_ptr<Bat> rightBat;
     std::shared_ptr<Board> board;
@@ -156,10 +166,14 @@ namespace pong
     unsigned char rightScore = 0;
     unsigned int countdownId;
     unsigned int ballId;
-    bool gameStarted = false;
+    std::atomic<bool> gameStarted = false;
+    std::atomic<unsigned long long> frameAllocations = 0;
+    unsigned long long tick = 0;
+    Seqlock<MatchSnapshot> snapshot;
     PongScene(anex::IGame &game, const std::shared_ptr<Bat> &leftBat, const std::shared_ptr<Bat> &rightBat);
     ~PongScene();
     void onCountdownZero();
+    void publishSnapshot();
   };
   struct PlayerBat : Bat
   {
@@ -176,9 +190,16 @@ namespace pong
   struct AIBat : Bat
   {
     std::thread activationThread;
-    std::shared_ptr<PongScene> pongScenePointer;
+    // the scene owns the bat, so this is not an owning pointer; ~PongScene stops the thread before it goes away
+    PongScene *pongScenePointer = 0;
+    std::atomic<bool> stopping = false;
+    // allocations of the last AI tick outside the network
+    std::atomic<unsigned long long> tickAllocations = 0;
+    AIController controller;
     AIBat(anex::IGame &game, const Bat::Side &side);
-    void startActivation(const std::shared_ptr<PongScene> &pongScenePointer);
+    ~AIBat();
+    void startActivation(PongScene &pongScene);
+    void stopActivation();
     void activationFunction();
   };
 }
\ No newline at end of file
@@ -0,0 +1,20 @@
+/*
+ */
+#pragma once
+#include <cstdint>
+#include <anex/modules/fenster/Fenster.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * Clipped span-based replacements for fenster_rect/fenster_circle/fenster_line. Every primitive is reduced to
+   * horizontal spans which rasterSpan fills 8-16 pixels per store batch with SSE2/AVX2/NEON where available.
+   */
+  void rasterSpan(uint32_t *pixels, int count, const uint32_t &color);
+  void rasterRect(::fenster *f, int x, int y, int width, int height, const uint32_t &color);
+  void rasterFrame(::fenster *f, const int &x, const int &y, const int &width, const int &height,
+                   const int &borderWidth, const uint32_t &color);
+  void rasterCircle(::fenster *f, const int &centerX, const int &centerY, const int &radius, const uint32_t &color);
+  void rasterLine(::fenster *f, int x0, int y0, int x1, int y1, const uint32_t &color);
+}
@@ -0,0 +1,75 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+/*
+ */
+namespace pong
+{
+  /*
+   * Single-writer seqlock. store() never waits on readers; load() retries until it copies a value that was not
+   * being written during the copy. The payload is held in relaxed atomic words so the copy itself is race free.
+   */
+  template <typename T>
+  struct Seqlock
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+    static constexpr unsigned long wordsSize = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    std::atomic<unsigned long long> sequence = 0;
+    std::array<std::atomic<uint64_t>, wordsSize> words{};
+    void store(const T &value)
+    {
+      uint64_t buffer[wordsSize] = {};
+      memcpy(buffer, &value, sizeof(T));
+      auto currentSequence = sequence.load(std::memory_order_relaxed);
+      sequence.store(currentSequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (unsigned long wordIndex = 0; wordIndex < wordsSize; ++wordIndex)
+      {
+        words[wordIndex].store(buffer[wordIndex], std::memory_order_relaxed);
+      }
+      sequence.store(currentSequence + 2, std::memory_order_release);
+    }
+    T load() const
+    {
+      T value;
+      while (!tryLoad(value))
+      {
+        std::this_thread::yield();
+      }
+      return value;
+    }
+    bool tryLoad(T &value) const
+    {
+      auto startSequence = sequence.load(std::memory_order_acquire);
+      if (startSequence & 1)
+      {
+        return false;
+      }
+      uint64_t buffer[wordsSize];
+      for (unsigned long wordIndex = 0; wordIndex < wordsSize; ++wordIndex)
+      {
+        buffer[wordIndex] = words[wordIndex].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) != startSequence)
+      {
+        return false;
+      }
+      memcpy(&value, buffer, sizeof(T));
+      return true;
+    }
+    /*
+     * Number of completed stores, readers can compare it to skip work when nothing new was published
+     */
+    unsigned long long version() const
+    {
+      return sequence.load(std::memory_order_acquire) / 2;
+    }
+  };
+}
@@ -0,0 +1,60 @@
+/*
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+/*
+ */
+namespace pong
+{
+  struct TraceEvent
+  {
+    const char *name;
+    char phase;
+    unsigned long long timestamp;
+    unsigned long long duration;
+    long long value;
+  };
+  /*
+   * Each thread appends to its own ring of blocks; only that thread writes blocks and size (the number of events
+   * ever pushed). A block is allocated when the ring first reaches it, so a short-lived thread costs one block
+   * instead of the whole ring. Once every block is full it keeps the latest capacity events, about half an hour of
+   * frames at 60 FPS, so an export has to wait until the recording threads have stopped.
+   */
+  struct TraceBuffer
+  {
+    static constexpr unsigned long blockCapacity = 1 << 12;
+    static constexpr unsigned long blocksSize = 1 << 8;
+    static constexpr unsigned long capacity = blockCapacity * blocksSize;
+    std::array<std::unique_ptr<TraceEvent[]>, blocksSize> blocks;
+    std::atomic<unsigned long long> size = 0;
+    std::atomic<const char *> threadName = "thread";
+    unsigned long threadId;
+    void push(const TraceEvent &event);
+    const TraceEvent &at(const unsigned long long &index) const;
+  };
+  struct Tracer
+  {
+    static std::atomic<bool> enabled;
+    static void enable();
+    static unsigned long long now();
+    static TraceBuffer &threadBuffer();
+    static void setThreadName(const char *name);
+    static void complete(const char *name, const unsigned long long &start, const unsigned long long &end);
+    static void instant(const char *name);
+    static void counter(const char *name, const long long &value);
+    static bool exportChromeTrace(const std::string &filename);
+  };
+  /*
+   * Records a complete ("X") event from construction to destruction when tracing is enabled
+   */
+  struct TraceScope
+  {
+    const char *name;
+    unsigned long long start = 0;
+    TraceScope(const char *eventName);
+    ~TraceScope();
+  };
+}
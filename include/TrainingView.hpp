@@ -0,0 +1,85 @@
+/*
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <Pong.hpp>
+#include <PolicyGradient.hpp>
+#include <Seqlock.hpp>
+/*
+ */
+namespace pong
+{
+  /*
+   * Totals published by the training thread after every batch
+   */
+  struct TrainingStats
+  {
+    unsigned long long batches;
+    unsigned long long steps;
+    float returnRate;
+    float stepsPerSecond;
+  };
+  /*
+   * Draws every match of a PolicyGradientTrainer as a scaled-down tile. Each tile and the header are drawn from one
+   * tryLoad (keeping the previous sample when it races a store), so the render thread never makes a rollout worker
+   * or the training thread wait. The trainer's matches have to be publishing snapshots. Tiles are redrawn
+   * round-robin until drawBudget is spent; the rest keep last frame's pixels, so a large grid costs a fixed slice of
+   * each frame rather than slowing the frame rate. fenster_text does not clip, so tiles too small for both labels
+   * (textMinWidth fits a 10 character rate) skip them; maxMatchesSize keeps tiles at least a few pixels wide.
+   */
+  struct MatchGridEntity : anex::IEntity
+  {
+    struct Tile
+    {
+      MatchSnapshot sample{};
+      unsigned long long rateVersion = 0;
+      unsigned long ticksPerSecond = 0;
+    };
+    static constexpr int headerHeight = 20;
+    static constexpr int textMinWidth = 72;
+    static constexpr int textMinHeight = 24;
+    static constexpr unsigned long maxMatchesSize = 1024;
+    static constexpr std::chrono::microseconds drawBudget{4000};
+    PolicyGradientTrainer &trainer;
+    const Seqlock<TrainingStats> &stats;
+    TrainingStats statsSample{};
+    std::vector<Tile> tiles;
+    int columns;
+    int rows;
+    int tileWidth;
+    int tileHeight;
+    unsigned long nextTile = 0;
+    bool cleared = false;
+    FramePacer::Clock::time_point rateStart;
+    MatchGridEntity(anex::IGame &gridGame, PolicyGradientTrainer &gridTrainer,
+                    const Seqlock<TrainingStats> &trainingStats);
+    void render() override;
+    void renderHeader(::fenster *f);
+    void renderTile(::fenster *f, const unsigned long &tileIndex);
+    void updateRates();
+  };
+  /*
+   * Train AI (Tiled): runs a PolicyGradientTrainer over many headless matches on a background thread and shows
+   * them all at once; settings.publishSnapshots must be set. onBatch is called on the training thread after each
+   * network update.
+   */
+  struct TrainingGridScene : anex::IScene
+  {
+    std::shared_ptr<FrameEntity> frameEntity;
+    PolicyGradientTrainer trainer;
+    Seqlock<TrainingStats> stats;
+    std::shared_ptr<MatchGridEntity> gridEntity;
+    std::function<void()> onBatch;
+    std::thread trainingThread;
+    TrainingGridScene(anex::IGame &sceneGame, std::shared_ptr<zeuron::NeuralNetwork> &network,
+                      std::mutex &networkMutex, ObservationNormalizer &normalizer,
+                      const PolicyGradientSettings &settings, const std::function<void()> &batchCallback);
+    ~TrainingGridScene();
+    void trainingFunction();
+  };
+}
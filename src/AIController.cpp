@@ -0,0 +1,120 @@
+/*
+ */
+#include <AIController.hpp>
+#include <AllocationCounter.hpp>
+#include <Trace.hpp>
+#include <cmath>
+using namespace pong;
+using namespace zeuron;
+/*
+ */
+static long double distance(const long double& a, const long double& b)
+{
+  return std::abs(a - b);
+};
+
+AIController::AIController(std::shared_ptr<NeuralNetwork>& sharedNetwork, std::mutex& sharedNetworkMutex,
+                           ObservationNormalizer& sharedNormalizer,
+                           std::atomic<unsigned long long>& sharedGeneration, const DecisionCache::Mode& cacheMode,
+                           const unsigned long& seed):
+  network(sharedNetwork),
+  networkMutex(sharedNetworkMutex),
+  normalizer(sharedNormalizer),
+  networkGeneration(sharedGeneration),
+  input(ObservationNormalizer::inputsSize),
+  expectedOutputs(2),
+  decisionCache(cacheMode),
+  random(seed)
+{
+};
+
+float AIController::decide(const MatchSnapshot& snapshot)
+{
+  if (snapshot.leftScore != lastLeftScore || snapshot.rightScore != lastRightScore)
+  {
+    bool leftWon = snapshot.leftScore != lastLeftScore;
+    if (datasetRecorder)
+    {
+      datasetRecorder->endRally(leftWon == leftSide ? 1 : -1);
+    }
+    lastLeftScore = snapshot.leftScore;
+    lastRightScore = snapshot.rightScore;
+  }
+  // a policy network was trained holding each sampled action, so it plays holding them too
+  if (snapshot.tick < nextDecisionTick)
+  {
+    return velocityY;
+  }
+  nextDecisionTick = snapshot.tick + (policyNetwork ? policyDecisionInterval : 1);
+  auto& hitPoint = snapshot.hitPoint;
+  auto batY = leftSide ? snapshot.leftBatY : snapshot.rightBatY;
+  observeMatch(snapshot, leftSide, batX, batHeight, input);
+  // auto yDifference = distance(y, hitPointY);
+  auto label = labelMatch(snapshot, leftSide, expectedOutputs);
+  // every decision is recorded, including the ones the cache answers below
+  if (datasetRecorder)
+  {
+    datasetRecorder->record(input, expectedOutputs);
+  }
+  auto decisionKey = DecisionCache::makeKey(hitPoint.x, hitPoint.y, batY, snapshot.ballX, snapshot.ballY,
+                                            snapshot.ballVelocityX, snapshot.ballVelocityY, label);
+  // a hit skips the backward pass of a supervised network too: the key holds the label, so the skipped sample
+  // would have repeated a recent one's target from a nearly identical observation
+  if (decisionCache.lookup(decisionKey, networkGeneration.load(std::memory_order_relaxed), decisionOutputs))
+  {
+    return applyOutputs();
+  }
+  std::unique_lock lock(networkMutex, std::defer_lock);
+  {
+    TraceScope lockWaitScope("aiNetworkMutex wait");
+    lock.lock();
+  }
+  auto& activeNetwork = *network;
+  normalizer.update(input);
+  normalizer.normalize(input);
+  AllocationScope networkScope;
+  {
+    TraceScope inferenceScope("AI inference");
+    activeNetwork.feedforward(input);
+  }
+  ++inferenceCount;
+  const auto& outputs = activeNetwork.getOutputs();
+  decisionOutputs[0] = outputs[0];
+  decisionOutputs[1] = outputs[1];
+  auto generation = networkGeneration.load(std::memory_order_relaxed);
+  // the hand-made labels would pull a policy network back towards the supervised one, so it only plays
+  if (!policyNetwork)
+  {
+    TraceScope backpropagateScope("AI backpropagate");
+    activeNetwork.backpropagate(expectedOutputs);
+    generation = networkGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  networkAllocations += networkScope.threadAllocations();
+  decisionCache.store(decisionKey, generation, decisionOutputs);
+  if (onInference)
+  {
+    onInference(activeNetwork);
+  }
+  return applyOutputs();
+};
+
+float AIController::applyOutputs()
+{
+  if (policyNetwork)
+  {
+    velocityY = samplePolicyAction(decisionOutputs[0], decisionOutputs[1], random, sampledActions);
+  }
+  else if (distance(decisionOutputs[0], 1) <= 0.03)
+  {
+    velocityY = -8;
+  }
+  else if (distance(decisionOutputs[1], 1) <= 0.03)
+  {
+    velocityY = 8;
+  }
+  else
+  {
+    velocityY = 0;
+  }
+  return velocityY;
+};
@@ -0,0 +1,163 @@
+/*
+ */
+#include <AINetwork.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <ByteStream.hpp>
+using namespace pong;
+using namespace zeuron;
+using namespace bs;
+/*
+ */
+std::pair<std::shared_ptr<char>, unsigned long> pong::readFileToBuffer(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+  {
+    throw std::ios_base::failure("Error: Unable to open file for reading.");
+  }
+  std::streampos fileSize = file.tellg();
+  if (fileSize <= 0)
+  {
+    throw std::ios_base::failure("Error: File is empty or has invalid size.");
+  }
+  unsigned long size = static_cast<unsigned long>(fileSize);
+  std::shared_ptr<char> buffer(new char[size], std::default_delete<char[]>());
+  file.seekg(0, std::ios::beg);
+  file.read(buffer.get(), size);
+  if (!file)
+  {
+    throw std::ios_base::failure("Error: Reading the file failed.");
+  }
+  file.close();
+  return std::make_pair(buffer, size);
+};
+
+void pong::writeBufferToFile(const char* buffer, unsigned long size, const std::string& filename)
+{
+  std::ofstream file(filename, std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cerr << "Error: Unable to open file for writing.\n";
+    return;
+  }
+  file.write(buffer, static_cast<std::streamsize>(size));
+  if (!file)
+  {
+    std::cerr << "Error: Writing to the file failed.\n";
+  }
+  file.close();
+};
+
+/*
+ * pong.nrl layout: "PNRL", uint32 version, uint32 training, uint64 networkSize, network bytes, observation
+ * normalizer bytes. Version 1 files have no training field and are supervised. Files without the magic are bare
+ * serialized networks from before the normalizer existed.
+ */
+constexpr char nrlMagic[4] = {'P', 'N', 'R', 'L'};
+constexpr uint32_t nrlVersion = 2;
+constexpr unsigned long nrlVersion1HeaderSize = sizeof(nrlMagic) + sizeof(uint32_t) + sizeof(uint64_t);
+constexpr unsigned long nrlHeaderSize = nrlVersion1HeaderSize + sizeof(uint32_t);
+
+std::shared_ptr<NeuralNetwork> pong::createAINetwork()
+{
+  return std::make_shared<NeuralNetwork>(
+    // Inputs: side, distance from bat to ball, bat height, ball velocity x/y, ball x/y, hit point x/y, each
+    // rescaled by ObservationNormalizer to roughly unit range
+    ObservationNormalizer::inputsSize,
+    std::vector<std::pair<NeuralNetwork::ActivationType, unsigned long>>({
+      {NeuralNetwork::ReLU, 10}, // First hidden layer with ReLU for feature extraction
+      {NeuralNetwork::ReLU, 8}, // Second hidden layer for refinement
+      {NeuralNetwork::Sigmoid, 4}, // Third hidden layer to add non-linearity
+      {NeuralNetwork::Sigmoid, 2} // Output layer: Sigmoid for binary outputs (keyUp, keyDown)
+    }),
+    0.01 // Reduced learning rate for stable convergence
+  );
+};
+
+std::shared_ptr<NeuralNetwork> pong::loadOrCreateAINetwork(const std::string& filename,
+                                                           ObservationNormalizer& normalizer,
+                                                           AINetworkTraining& training)
+{
+  training = SupervisedTraining;
+  try
+  {
+    auto bytesSizePair = readFileToBuffer(filename);
+    auto& bytes = std::get<0>(bytesSizePair);
+    auto& size = std::get<1>(bytesSizePair);
+    if (size < nrlVersion1HeaderSize || memcmp(bytes.get(), nrlMagic, sizeof(nrlMagic)))
+    {
+      ByteStream byteStream(size, bytes);
+      return std::make_shared<NeuralNetwork>(byteStream);
+    }
+    uint32_t version;
+    memcpy(&version, bytes.get() + sizeof(nrlMagic), sizeof(version));
+    auto headerSize = version == 1 ? nrlVersion1HeaderSize : nrlHeaderSize;
+    if ((version != 1 && version != nrlVersion) || size < headerSize)
+    {
+      throw std::ios_base::failure("Error: Unsupported network file version.");
+    }
+    if (version == nrlVersion)
+    {
+      uint32_t storedTraining;
+      memcpy(&storedTraining, bytes.get() + sizeof(nrlMagic) + sizeof(version), sizeof(storedTraining));
+      training = storedTraining == PolicyGradientTraining ? PolicyGradientTraining : SupervisedTraining;
+    }
+    uint64_t networkSize;
+    memcpy(&networkSize, bytes.get() + headerSize - sizeof(networkSize), sizeof(networkSize));
+    if (networkSize > size - headerSize)
+    {
+      throw std::ios_base::failure("Error: Unsupported network file version.");
+    }
+    // aliases the file buffer so the network bytes are not copied
+    std::shared_ptr<char> networkBytes(bytes, bytes.get() + headerSize);
+    ByteStream byteStream(networkSize, networkBytes);
+    auto network = std::make_shared<NeuralNetwork>(byteStream);
+    auto normalizerOffset = headerSize + networkSize;
+    if (!normalizer.deserialize(bytes.get() + normalizerOffset, size - normalizerOffset))
+    {
+      std::cerr << "Warning: " << filename << " has no usable observation statistics, starting fresh.\n";
+    }
+    return network;
+  }
+  catch (...)
+  {
+    training = SupervisedTraining;
+    return createAINetwork();
+  }
+};
+
+void pong::saveAINetwork(NeuralNetwork& network, const ObservationNormalizer& normalizer,
+                         const AINetworkTraining& training, const std::string& filename)
+{
+  auto nnStream = network.serialize();
+  std::string bytes(nrlMagic, sizeof(nrlMagic));
+  uint32_t storedTraining = training;
+  uint64_t networkSize = nnStream.bytesSize;
+  bytes.append((const char *)&nrlVersion, sizeof(nrlVersion));
+  bytes.append((const char *)&storedTraining, sizeof(storedTraining));
+  bytes.append((const char *)&networkSize, sizeof(networkSize));
+  bytes.append(nnStream.bytes.get(), nnStream.bytesSize);
+  normalizer.serialize(bytes);
+  writeBufferToFile(bytes.data(), bytes.size(), filename);
+};
+
+void pong::warnOnScalingChange(const ObservationNormalizer& normalizer, const std::string& filename)
+{
+  if (normalizer.storedMode != normalizer.mode)
+  {
+    std::cerr << "Warning: " << filename << " was saved " << (normalizer.storedMode ==
+      ObservationNormalizer::PlayAreaScaling ? "with" : "without") << " --fixed-scaling, its inputs will be scaled "
+      "differently from how it was trained.\n";
+  }
+};
+
+std::shared_ptr<NeuralNetwork> pong::copyAINetwork(const char* bytes, const unsigned long& size)
+{
+  std::shared_ptr<char> bytesCopy(new char[size], std::default_delete<char[]>());
+  memcpy(bytesCopy.get(), bytes, size);
+  ByteStream byteStream(size, bytesCopy);
+  return std::make_shared<NeuralNetwork>(byteStream);
+};
@@ -0,0 +1,166 @@
+/*
+ */
+#include <AllocationCounter.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+using namespace pong;
+/*
+ */
+static std::atomic<unsigned long long> processAllocationTotal = 0;
+static thread_local unsigned long long threadAllocationTotal = 0;
+
+static void *countedAllocate(std::size_t size)
+{
+  processAllocationTotal.fetch_add(1, std::memory_order_relaxed);
+  ++threadAllocationTotal;
+  if (auto pointer = std::malloc(size ? size : 1))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+};
+
+static void *countedAlignedAllocate(std::size_t size, std::align_val_t alignment)
+{
+  processAllocationTotal.fetch_add(1, std::memory_order_relaxed);
+  ++threadAllocationTotal;
+  auto alignmentSize = static_cast<std::size_t>(alignment);
+  size = (size + alignmentSize - 1) / alignmentSize * alignmentSize;
+#if defined(_WIN32)
+  if (auto pointer = _aligned_malloc(size ? size : alignmentSize, alignmentSize))
+#else
+  if (auto pointer = std::aligned_alloc(alignmentSize, size ? size : alignmentSize))
+#endif
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+};
+
+static void alignedFree(void *pointer)
+{
+#if defined(_WIN32)
+  _aligned_free(pointer);
+#else
+  std::free(pointer);
+#endif
+};
+
+void *operator new(std::size_t size)
+{
+  return countedAllocate(size);
+};
+
+void *operator new[](std::size_t size)
+{
+  return countedAllocate(size);
+};
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  try
+  {
+    return countedAllocate(size);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+};
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  try
+  {
+    return countedAllocate(size);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+};
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+  return countedAlignedAllocate(size, alignment);
+};
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return countedAlignedAllocate(size, alignment);
+};
+
+void operator delete(void *pointer) noexcept
+{
+  std::free(pointer);
+};
+
+void operator delete[](void *pointer) noexcept
+{
+  std::free(pointer);
+};
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+};
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+};
+
+void operator delete(void *pointer, std::align_val_t) noexcept
+{
+  alignedFree(pointer);
+};
+
+void operator delete[](void *pointer, std::align_val_t) noexcept
+{
+  alignedFree(pointer);
+};
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept
+{
+  alignedFree(pointer);
+};
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept
+{
+  alignedFree(pointer);
+};
+
+unsigned long long pong::processAllocationCount()
+{
+  return processAllocationTotal.load(std::memory_order_relaxed);
+};
+
+unsigned long long pong::threadAllocationCount()
+{
+  return threadAllocationTotal;
+};
+
+AllocationScope::AllocationScope()
+{
+  reset();
+};
+
+unsigned long long AllocationScope::processAllocations() const
+{
+  return processAllocationCount() - processStart;
+};
+
+unsigned long long AllocationScope::threadAllocations() const
+{
+  return threadAllocationCount() - threadStart;
+};
+
+void AllocationScope::reset()
+{
+  processStart = processAllocationCount();
+  threadStart = threadAllocationCount();
+};
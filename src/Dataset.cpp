@@ -0,0 +1,323 @@
+/*
+ */
+#include <Dataset.hpp>
+#include <cstring>
+#include <ios>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace pong;
+/*
+ */
+unsigned long DatasetFormat::chunkSize(const unsigned long& recordsSize)
+{
+  unsigned long size = chunkHeaderSize + (observationWidth + expectedWidth) * sizeof(float) * recordsSize +
+    recordsSize;
+  return (size + 3) / 4 * 4;
+};
+
+DatasetWriter::DatasetWriter(const std::string& filename, const unsigned long& poolSize):
+  file(filename, std::ios::binary)
+{
+  if (!file.is_open())
+  {
+    throw std::ios_base::failure("Error: Unable to open dataset file for writing.");
+  }
+  uint32_t header[3] = {DatasetFormat::version, DatasetFormat::observationWidth, DatasetFormat::expectedWidth};
+  file.write(DatasetFormat::magic, sizeof(DatasetFormat::magic));
+  file.write((const char*)header, sizeof(header));
+  // every chunk that will ever exist is created here, so none of these vectors grow later
+  freeChunks.reserve(poolSize);
+  fullChunks.reserve(poolSize);
+  writingChunks.reserve(poolSize);
+  for (unsigned long chunkIndex = 0; chunkIndex < poolSize; ++chunkIndex)
+  {
+    freeChunks.push_back(std::make_unique<DatasetChunk>());
+  }
+  writerThread = std::thread(&DatasetWriter::run, this);
+};
+
+DatasetWriter::~DatasetWriter()
+{
+  close();
+};
+
+/*
+ * Writes every submitted chunk, then stops the writer thread. Chunks submitted afterwards are never written.
+ */
+void DatasetWriter::close()
+{
+  {
+    std::lock_guard lock(chunksMutex);
+    open = false;
+  }
+  chunksCondition.notify_one();
+  if (writerThread.joinable())
+  {
+    writerThread.join();
+    file.close();
+  }
+};
+
+std::unique_ptr<DatasetChunk> DatasetWriter::acquire()
+{
+  std::lock_guard lock(chunksMutex);
+  if (freeChunks.empty())
+  {
+    return nullptr;
+  }
+  auto chunk = std::move(freeChunks.back());
+  freeChunks.pop_back();
+  chunk->size = 0;
+  return chunk;
+};
+
+void DatasetWriter::submit(std::unique_ptr<DatasetChunk> chunk)
+{
+  {
+    std::lock_guard lock(chunksMutex);
+    if (!chunk->size)
+    {
+      freeChunks.push_back(std::move(chunk));
+      return;
+    }
+    fullChunks.push_back(std::move(chunk));
+  }
+  chunksCondition.notify_one();
+};
+
+void DatasetWriter::run()
+{
+  static const char padding[4] = {};
+  std::unique_lock lock(chunksMutex);
+  while (true)
+  {
+    chunksCondition.wait(lock, [&]
+    {
+      return !fullChunks.empty() || !open;
+    });
+    if (fullChunks.empty())
+    {
+      return;
+    }
+    std::swap(fullChunks, writingChunks);
+    lock.unlock();
+    for (auto& chunk : writingChunks)
+    {
+      auto size = chunk->size;
+      uint32_t recordsSize = size;
+      file.write(DatasetFormat::chunkMagic, sizeof(DatasetFormat::chunkMagic));
+      file.write((const char*)&recordsSize, sizeof(recordsSize));
+      for (auto& column : chunk->observations)
+      {
+        file.write((const char*)column.data(), size * sizeof(float));
+      }
+      for (auto& column : chunk->expectedOutputs)
+      {
+        file.write((const char*)column.data(), size * sizeof(float));
+      }
+      file.write((const char*)chunk->outcomes.data(), size);
+      file.write(padding, (4 - size % 4) % 4);
+      writtenRecords.fetch_add(size, std::memory_order_relaxed);
+    }
+    file.flush();
+    lock.lock();
+    for (auto& chunk : writingChunks)
+    {
+      freeChunks.push_back(std::move(chunk));
+    }
+    writingChunks.clear();
+  }
+};
+
+DatasetRecorder::DatasetRecorder(const std::shared_ptr<DatasetWriter>& writer):
+  writer(writer),
+  chunk(writer->acquire())
+{
+};
+
+DatasetRecorder::~DatasetRecorder()
+{
+  if (chunk)
+  {
+    writer->submit(std::move(chunk));
+  }
+};
+
+void DatasetRecorder::record(const std::vector<long double>& observation,
+                             const std::vector<long double>& expectedOutput)
+{
+  if (!chunk)
+  {
+    chunk = writer->acquire();
+    rallyStart = 0;
+    if (!chunk)
+    {
+      writer->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+  auto index = chunk->size++;
+  for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+  {
+    chunk->observations[column][index] = float(observation[column]);
+  }
+  for (unsigned long column = 0; column < DatasetFormat::expectedWidth; ++column)
+  {
+    chunk->expectedOutputs[column][index] = float(expectedOutput[column]);
+  }
+  chunk->outcomes[index] = 0;
+  if (chunk->size == DatasetChunk::capacity)
+  {
+    flush();
+  }
+};
+
+void DatasetRecorder::endRally(const int8_t& outcome)
+{
+  if (!chunk)
+  {
+    return;
+  }
+  for (auto index = rallyStart; index < chunk->size; ++index)
+  {
+    chunk->outcomes[index] = outcome;
+  }
+  rallyStart = chunk->size;
+};
+
+void DatasetRecorder::flush()
+{
+  if (chunk)
+  {
+    writer->submit(std::move(chunk));
+  }
+  chunk = writer->acquire();
+  rallyStart = 0;
+};
+
+MappedDataset::MappedDataset(const std::string& filename)
+{
+#if defined(_WIN32)
+  fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    fileHandle = nullptr;
+    throw std::ios_base::failure("Error: Unable to open dataset file for reading.");
+  }
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(fileHandle, &fileSize);
+  size = (unsigned long)fileSize.QuadPart;
+  mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mappingHandle)
+  {
+    unmap();
+    throw std::ios_base::failure("Error: Unable to map dataset file.");
+  }
+  data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+  if (!data)
+  {
+    unmap();
+    throw std::ios_base::failure("Error: Unable to map dataset file.");
+  }
+#else
+  int descriptor = ::open(filename.c_str(), O_RDONLY);
+  if (descriptor < 0)
+  {
+    throw std::ios_base::failure("Error: Unable to open dataset file for reading.");
+  }
+  struct stat fileStat;
+  fstat(descriptor, &fileStat);
+  size = (unsigned long)fileStat.st_size;
+  auto mapping = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+  ::close(descriptor);
+  if (mapping == MAP_FAILED)
+  {
+    throw std::ios_base::failure("Error: Unable to map dataset file.");
+  }
+  madvise(mapping, size, MADV_SEQUENTIAL);
+  data = (const char*)mapping;
+#endif
+  uint32_t header[3];
+  if (size < DatasetFormat::headerSize || memcmp(data, DatasetFormat::magic, sizeof(DatasetFormat::magic)))
+  {
+    unmap();
+    throw std::ios_base::failure("Error: Not a pong dataset file.");
+  }
+  memcpy(header, data + sizeof(DatasetFormat::magic), sizeof(header));
+  if (header[0] != DatasetFormat::version || header[1] != DatasetFormat::observationWidth ||
+    header[2] != DatasetFormat::expectedWidth)
+  {
+    unmap();
+    throw std::ios_base::failure("Error: Unsupported pong dataset version or layout.");
+  }
+  unsigned long offset = DatasetFormat::headerSize;
+  while (offset + DatasetFormat::chunkHeaderSize <= size)
+  {
+    uint32_t chunkRecordsSize;
+    memcpy(&chunkRecordsSize, data + offset + sizeof(DatasetFormat::chunkMagic), sizeof(chunkRecordsSize));
+    auto chunkSize = DatasetFormat::chunkSize(chunkRecordsSize);
+    if (memcmp(data + offset, DatasetFormat::chunkMagic, sizeof(DatasetFormat::chunkMagic)) ||
+      offset + chunkSize > size)
+    {
+      // a truncated tail (e.g. the game was killed mid-write) ends the dataset
+      break;
+    }
+    DatasetChunkView chunk;
+    chunk.size = chunkRecordsSize;
+    auto columns = (const float*)(data + offset + DatasetFormat::chunkHeaderSize);
+    for (auto& column : chunk.observations)
+    {
+      column = columns;
+      columns += chunkRecordsSize;
+    }
+    for (auto& column : chunk.expectedOutputs)
+    {
+      column = columns;
+      columns += chunkRecordsSize;
+    }
+    chunk.outcomes = (const int8_t*)columns;
+    chunks.push_back(chunk);
+    recordsSize += chunkRecordsSize;
+    offset += chunkSize;
+  }
+};
+
+MappedDataset::~MappedDataset()
+{
+  unmap();
+};
+
+void MappedDataset::unmap()
+{
+#if defined(_WIN32)
+  if (data)
+  {
+    UnmapViewOfFile(data);
+  }
+  if (mappingHandle)
+  {
+    CloseHandle(mappingHandle);
+  }
+  if (fileHandle)
+  {
+    CloseHandle(fileHandle);
+  }
+  data = nullptr;
+  mappingHandle = nullptr;
+  fileHandle = nullptr;
+#else
+  if (data)
+  {
+    munmap((void*)data, size);
+  }
+  data = nullptr;
+#endif
+};
@@ -0,0 +1,65 @@
+/*
+ */
+#include <DecisionCache.hpp>
+#include <cmath>
+using namespace pong;
+/*
+ */
+DecisionCache::DecisionCache(const Mode& mode, const unsigned long long& maxAge):
+  mode(mode),
+  maxAge(maxAge)
+{
+};
+
+unsigned long long DecisionCache::makeKey(const float& hitPointX, const float& hitPointY, const float& batY,
+                                          const float& ballX, const float& ballY, const float& velocityX,
+                                          const float& velocityY, const unsigned int& label)
+{
+  // 10 bits each for the hit point x/y, bat y and ball x/y buckets, 1 bit direction, 2 bits label, 8 bits rounded
+  // vertical speed
+  auto bucket = [](const float& value) -> unsigned long long
+  {
+    return (unsigned long long)((long long)std::floor(value / bucketSize) & 0x3ff);
+  };
+  unsigned long long key = bucket(hitPointX);
+  key = key << 10 | bucket(hitPointY);
+  key = key << 10 | bucket(batY);
+  key = key << 10 | bucket(ballX);
+  key = key << 10 | bucket(ballY);
+  key = key << 1 | (velocityX > 0 ? 1 : 0);
+  key = key << 2 | (label & 0x3);
+  key = key << 8 | ((unsigned long long)((long long)std::lround(velocityY) & 0xff));
+  return key;
+};
+
+bool DecisionCache::lookup(const unsigned long long& key, const unsigned long long& generation,
+                           std::array<long double, 2>& outputs)
+{
+  if (mode == Off)
+  {
+    return false;
+  }
+  ++lookups;
+  auto& entry = mode == OnChange ? lastEntry : entries[(key * 0x9E3779B97F4A7C15ull) >> 52];
+  if (!entry.valid || entry.key != key || generation - entry.generation > maxAge)
+  {
+    return false;
+  }
+  ++hits;
+  outputs = entry.outputs;
+  return true;
+};
+
+void DecisionCache::store(const unsigned long long& key, const unsigned long long& generation,
+                          const std::array<long double, 2>& outputs)
+{
+  if (mode == Off)
+  {
+    return;
+  }
+  auto& entry = mode == OnChange ? lastEntry : entries[(key * 0x9E3779B97F4A7C15ull) >> 52];
+  entry.key = key;
+  entry.generation = generation;
+  entry.valid = true;
+  entry.outputs = outputs;
+};
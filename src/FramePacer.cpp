@@ -0,0 +1,101 @@
+/*
+ */
+#include <FramePacer.hpp>
+#include <algorithm>
+#include <thread>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+using namespace pong;
+/*
+ */
+FramePacer::FramePacer(const int& targetFPS, const int& idleFPS):
+  targetFPS(std::max(targetFPS, 1)),
+  idleFPS(std::max(idleFPS, 1)),
+  nextFrame(Clock::now()),
+  lastWake(nextFrame),
+  reportStart(nextFrame),
+  reportCPUStart(processCPUSeconds())
+{
+};
+
+void FramePacer::pace()
+{
+  auto now = Clock::now();
+  idle = idleEligible.load(std::memory_order_relaxed) && now - lastWake.load(std::memory_order_relaxed) >= idleDelay;
+  auto period = std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>(1.0 / (idle ? idleFPS : targetFPS)));
+  nextFrame += period;
+  if (nextFrame < now)
+  {
+    // fell behind (or just woke from idle), resync instead of bursting to catch up
+    nextFrame = now;
+    return;
+  }
+  if (nextFrame - now > period)
+  {
+    // left idle mid-period, don't finish out the long idle frame
+    nextFrame = now + period;
+  }
+  if (nextFrame - now > spinMargin)
+  {
+    std::this_thread::sleep_until(nextFrame - spinMargin);
+  }
+  while (Clock::now() < nextFrame)
+  {
+    std::this_thread::yield();
+  }
+};
+
+void FramePacer::wake()
+{
+  // idle itself is only written by pace(), which recomputes it from lastWake on the next frame
+  lastWake.store(Clock::now(), std::memory_order_relaxed);
+};
+
+void FramePacer::setIdleEligible(const bool& eligible)
+{
+  idleEligible.store(eligible, std::memory_order_relaxed);
+  wake();
+};
+
+bool FramePacer::updateStats()
+{
+  ++reportFrames;
+  auto now = Clock::now();
+  std::chrono::duration<double> elapsed = now - reportStart;
+  if (elapsed < reportPeriod)
+  {
+    return false;
+  }
+  auto cpu = processCPUSeconds();
+  achievedFPS = reportFrames / elapsed.count();
+  cpuPercent = 100 * (cpu - reportCPUStart) / elapsed.count();
+  reportStart = now;
+  reportCPUStart = cpu;
+  reportFrames = 0;
+  return true;
+};
+
+/*
+ * CPU time of the whole process (all threads), so cpuPercent can exceed 100 on multiple cores
+ */
+double FramePacer::processCPUSeconds()
+{
+#if defined(_WIN32)
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+  auto toSeconds = [](const FILETIME& time)
+  {
+    return (double(time.dwHighDateTime) * 4294967296.0 + time.dwLowDateTime) / 1e7;
+  };
+  return toSeconds(kernelTime) + toSeconds(userTime);
+#else
+  timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+};
@@ -0,0 +1,259 @@
+/*
+ */
+#include <Match.hpp>
+#include <cmath>
+#include <limits>
+using namespace pong;
+/*
+ */
+void pong::serveBall(std::mt19937& random, float& velocityX, float& velocityY)
+{
+  std::uniform_int_distribution<int> distribution(1, 4);
+  auto startingDirection = distribution(random);
+  switch (startingDirection)
+  {
+  case 1:
+    {
+      velocityX = 4;
+      velocityY = 2;
+      break;
+    };
+  case 2:
+    {
+      velocityX = -4;
+      velocityY = 2;
+      break;
+    };
+  case 3:
+    {
+      velocityX = 4;
+      velocityY = -2;
+      break;
+    };
+  case 4:
+    {
+      velocityX = -4;
+      velocityY = -2;
+      break;
+    };
+  }
+};
+
+void pong::stepBat(float& y, const float& velocityY, const int& height, const int& windowHeight)
+{
+  if ((velocityY < 0 && y - height / 2 > 44) || (velocityY > 0 && y + height / 2 < windowHeight - 44))
+  {
+    y += velocityY;
+  }
+};
+
+BallEvent pong::stepBall(float& x, float& y, float& velocityX, float& velocityY, const float& leftBatY,
+                         const float& leftBatVelocityY, const float& rightBatY, const float& rightBatVelocityY,
+                         const int& batHeight, const int& windowWidth, const int& windowHeight)
+{
+  x += velocityX;
+  y += velocityY;
+  if (y <= 40 || y >= windowHeight - 40)
+  {
+    velocityY = -velocityY;
+    return WallBounced;
+  }
+  if (x > 28 && x < windowWidth - 28)
+  {
+    return BallMoved;
+  }
+  if (x <= 16)
+  {
+    return RightScored;
+  }
+  if (x >= windowWidth - 16)
+  {
+    return LeftScored;
+  }
+  // the bats are only checked on the exact column the ball reaches them on
+  if (x == 28)
+  {
+    if (y < leftBatY - batHeight / 2 || y > leftBatY + batHeight / 2)
+    {
+      return BallMoved;
+    }
+    velocityY = velocityY + leftBatVelocityY;
+    velocityX = -velocityX;
+    return LeftBatHit;
+  }
+  if (x == windowWidth - 28)
+  {
+    if (y < rightBatY - batHeight / 2 || y > rightBatY + batHeight / 2)
+    {
+      return BallMoved;
+    }
+    velocityY = velocityY + rightBatVelocityY;
+    velocityX = -velocityX;
+    return RightBatHit;
+  }
+  return BallMoved;
+};
+
+void pong::calculateTrajectory(const Point& position, const Point& velocity, const PlayArea& playArea,
+                               std::vector<Bounce>& bounces, Point& hitPoint)
+{
+  bounces.clear();
+  Point currentPos = position;
+  Point currentVelocity = velocity;
+  float leftWall = playArea.x - (playArea.width / 2);
+  float rightWall = playArea.width + playArea.x - (playArea.width / 2);
+  float topWall = playArea.y - (playArea.height / 2);
+  float bottomWall = playArea.height + playArea.y - (playArea.height / 2);
+
+  while (true)
+  {
+    float timeToVerticalWall = std::numeric_limits<float>::infinity();
+    float timeToHorizontalWall = std::numeric_limits<float>::infinity();
+
+    // Calculate time to the next vertical wall (left or right)
+    if (currentVelocity.x > 0)
+    {
+      timeToVerticalWall = (rightWall - currentPos.x) / currentVelocity.x;
+    }
+    else if (currentVelocity.x < 0)
+    {
+      timeToVerticalWall = (leftWall - currentPos.x) / currentVelocity.x;
+    }
+
+    // Calculate time to the next horizontal wall (top or bottom)
+    if (currentVelocity.y > 0)
+    {
+      timeToHorizontalWall = (bottomWall - currentPos.y) / currentVelocity.y;
+    }
+    else if (currentVelocity.y < 0)
+    {
+      timeToHorizontalWall = (topWall - currentPos.y) / currentVelocity.y;
+    }
+
+    // Determine which wall will be hit first
+    if (timeToVerticalWall < timeToHorizontalWall)
+    {
+      // Ball hits a vertical wall
+      Point nextPos = {
+        currentPos.x + currentVelocity.x * timeToVerticalWall, currentPos.y + currentVelocity.y * timeToVerticalWall
+      };
+      bounces.push_back({currentPos, nextPos});
+
+      // Check if it's a final hit (left or right wall)
+      if (nextPos.x == leftWall || nextPos.x == rightWall)
+      {
+        hitPoint = nextPos;
+        return;
+      }
+
+      // Update for bounce
+      currentPos = nextPos;
+      currentVelocity.x = -currentVelocity.x; // Reverse horizontal direction
+    }
+    else
+    {
+      // Ball hits a horizontal wall
+      Point nextPos = {
+        currentPos.x + currentVelocity.x * timeToHorizontalWall,
+        currentPos.y + currentVelocity.y * timeToHorizontalWall
+      };
+      bounces.push_back({currentPos, nextPos});
+
+      // Update for bounce
+      currentPos = nextPos;
+      currentVelocity.y = -currentVelocity.y; // Reverse vertical direction
+    }
+  }
+};
+
+void pong::observeMatch(const MatchSnapshot& snapshot, const bool& leftSide, const float& batX,
+                        const int& batHeight, std::vector<long double>& input)
+{
+  long double batY = leftSide ? snapshot.leftBatY : snapshot.rightBatY;
+  long double dx = batX - (long double)snapshot.ballX;
+  long double dy = batY - snapshot.ballY;
+  input[0] = leftSide ? 0 : 1;
+  input[1] = std::sqrt(dx * dx + dy * dy);
+  input[2] = batHeight;
+  input[3] = snapshot.ballVelocityX;
+  input[4] = snapshot.ballVelocityY;
+  input[5] = snapshot.ballX;
+  input[6] = snapshot.ballY;
+  input[7] = snapshot.hitPoint.x;
+  input[8] = snapshot.hitPoint.y;
+};
+
+unsigned int pong::labelMatch(const MatchSnapshot& snapshot, const bool& leftSide,
+                              std::vector<long double>& expectedOutputs)
+{
+  auto& hitPoint = snapshot.hitPoint;
+  auto batY = leftSide ? snapshot.leftBatY : snapshot.rightBatY;
+  auto onSide = leftSide ? hitPoint.x == 12 : hitPoint.x == 948;
+  expectedOutputs[0] = !onSide || hitPoint.y > batY ? 0 : 1;
+  expectedOutputs[1] = !onSide || hitPoint.y < batY ? 0 : 1;
+  return (unsigned int)expectedOutputs[0] + 2 * (unsigned int)expectedOutputs[1];
+};
+
+float pong::samplePolicyAction(const long double& upProbability, const long double& downProbability,
+                               std::mt19937& random, std::array<long double, 2>& actions)
+{
+  std::uniform_real_distribution<long double> uniform(0, 1);
+  actions[0] = uniform(random) < upProbability ? 1 : 0;
+  actions[1] = uniform(random) < downProbability ? 1 : 0;
+  return actions[0] ? -8 : actions[1] ? 8 : 0;
+};
+
+/*
+ * Geometry matches PongGame's Bat, Board and Ball for the same window size
+ */
+HeadlessMatch::HeadlessMatch(const int& windowWidth, const int& windowHeight, const unsigned long& seed):
+  windowWidth(windowWidth),
+  windowHeight(windowHeight),
+  batHeight(windowHeight / 5),
+  leftBatX(20),
+  rightBatX(windowWidth - 20),
+  playArea({(float)(12 + (windowWidth - 24) / 2), (float)(36 + (windowHeight - 72) / 2), (float)windowWidth - 24,
+            (float)windowHeight - 72}),
+  random(seed)
+{
+  bounces.reserve(16);
+  state.leftBatY = windowHeight / 2;
+  state.rightBatY = windowHeight / 2;
+  serve();
+};
+
+void HeadlessMatch::serve()
+{
+  state.ballX = windowWidth / 2;
+  state.ballY = windowHeight / 2;
+  serveBall(random, state.ballVelocityX, state.ballVelocityY);
+  calculateTrajectory({state.ballX, state.ballY}, {state.ballVelocityX, state.ballVelocityY}, playArea, bounces,
+                      state.hitPoint);
+};
+
+/*
+ * Same order as a rendered frame: bats move, then the ball, then the trajectory is recalculated
+ */
+BallEvent HeadlessMatch::step()
+{
+  ++state.tick;
+  stepBat(state.leftBatY, leftBatVelocityY, batHeight, windowHeight);
+  stepBat(state.rightBatY, rightBatVelocityY, batHeight, windowHeight);
+  auto event = stepBall(state.ballX, state.ballY, state.ballVelocityX, state.ballVelocityY, state.leftBatY,
+                        leftBatVelocityY, state.rightBatY, rightBatVelocityY, batHeight, windowWidth, windowHeight);
+  if (event == LeftScored || event == RightScored)
+  {
+    ++(event == LeftScored ? state.leftScore : state.rightScore);
+    serve();
+  }
+  else
+  {
+    calculateTrajectory({state.ballX, state.ballY}, {state.ballVelocityX, state.ballVelocityY}, playArea, bounces,
+                        state.hitPoint);
+  }
+  if (publishSnapshots)
+  {
+    snapshot.store(state);
+  }
+  return event;
+};
@@ -0,0 +1,45 @@
+/*
+ */
+#include <MatchView.hpp>
+#include <Raster.hpp>
+#include <charconv>
+using namespace pong;
+/*
+ */
+void pong::drawBoard(::fenster* f, const int& windowWidth, const int& windowHeight, const unsigned char& leftScore,
+                     const unsigned char& rightScore)
+{
+  char leftScoreText[4];
+  char rightScoreText[4];
+  *std::to_chars(leftScoreText, leftScoreText + 3, leftScore).ptr = 0;
+  *std::to_chars(rightScoreText, rightScoreText + 3, rightScore).ptr = 0;
+  // white border
+  rasterFrame(f, 8, 32, windowWidth - 16, windowHeight - 64, 4, 0x00ffffff);
+  // black play area between the hit rects
+  rasterRect(f, 16, 36, windowWidth - 32, windowHeight - 72, 0x00000000);
+  // blue left hit rect
+  rasterRect(f, 12, 36, 4, windowHeight - 72, 0x000000ff);
+  // red right hit rect
+  rasterRect(f, windowWidth - 16, 36, 4, windowHeight - 72, 0x00ff0000);
+  // left score
+  fenster_text(f, windowWidth / 4, 6, leftScoreText, 4, 0x00ffffff);
+  // right score
+  fenster_text(f, windowWidth / 2 + windowWidth / 4, 6, rightScoreText, 4, 0x00ffffff);
+};
+
+void pong::drawBat(::fenster* f, const float& x, const float& y, const int& height, const uint32_t& color)
+{
+  rasterRect(f, x - 2, y - height / 2, 4, height, color);
+};
+
+void pong::drawBall(::fenster* f, const float& x, const float& y, const int& radius,
+                    const std::vector<Bounce>& bounces)
+{
+  rasterCircle(f, x, y, radius, 0x00ffffff);
+  for (auto& bounce : bounces)
+  {
+    auto& start = bounce.start;
+    auto& end = bounce.end;
+    rasterLine(f, start.x, start.y, end.x, end.y, 0x0000ff00);
+  }
+};
@@ -0,0 +1,159 @@
+/*
+ */
+#include <NetworkVisualizer.hpp>
+#include <Raster.hpp>
+#include <algorithm>
+#include <cmath>
+using namespace pong;
+using namespace zeuron;
+/*
+ */
+NetworkVisualizer::NetworkVisualizer(const NeuralNetwork& network,
+                                     const int& width,
+                                     const int& height,
+                                     const int& refreshRate,
+                                     const long double& threshold):
+  width(width),
+  height(height),
+  refreshRate(refreshRate),
+  threshold(threshold),
+  refreshPeriod(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(1.0 / std::max(refreshRate, 1)))),
+  publishedWeights(network.weights),
+  snapshotDirty(true),
+  pixels(width * height, 0x00000000),
+  visualizerThread(&NetworkVisualizer::run, this)
+{
+};
+
+NetworkVisualizer::~NetworkVisualizer()
+{
+  open = false;
+  visualizerThread.join();
+};
+
+void NetworkVisualizer::publish(const NeuralNetwork& network)
+{
+  auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  if (now - lastPublishTicks.load(std::memory_order_relaxed) < refreshPeriod.count())
+  {
+    return;
+  }
+  std::unique_lock lock(snapshotMutex, std::try_to_lock);
+  if (!lock.owns_lock())
+  {
+    return;
+  }
+  lastPublishTicks.store(now, std::memory_order_relaxed);
+  // same shape every time, so this reuses the back buffer's storage
+  publishedWeights = network.weights;
+  snapshotDirty = true;
+};
+
+void NetworkVisualizer::run()
+{
+  ::fenster f = {.title = "Pong Network", .width = width, .height = height, .buf = pixels.data()};
+  fenster_open(&f);
+  auto nextFrame = std::chrono::steady_clock::now();
+  while (open && fenster_loop(&f) == 0)
+  {
+    {
+      std::lock_guard lock(snapshotMutex);
+      if (snapshotDirty)
+      {
+        std::swap(frontWeights, publishedWeights);
+        snapshotDirty = false;
+      }
+    }
+    bool changed = false;
+    auto layersSize = frontWeights.size();
+    bool fullRedraw = drawnWeights.size() != layersSize;
+    if (fullRedraw)
+    {
+      rasterRect(&f, 0, 0, width, height, 0x00000000);
+      drawnWeights = frontWeights;
+    }
+    for (unsigned long layerIndex = 0; layerIndex < layersSize; ++layerIndex)
+    {
+      auto& layer = frontWeights[layerIndex];
+      auto& drawnLayer = drawnWeights[layerIndex];
+      for (unsigned long neuronIndex = 0; neuronIndex < layer.size(); ++neuronIndex)
+      {
+        auto& neuron = layer[neuronIndex];
+        auto& drawnNeuron = drawnLayer[neuronIndex];
+        for (unsigned long inputIndex = 0; inputIndex < neuron.size(); ++inputIndex)
+        {
+          auto& weight = neuron[inputIndex];
+          auto& drawnWeight = drawnNeuron[inputIndex];
+          if (!fullRedraw && std::abs(weight - drawnWeight) <= threshold)
+          {
+            continue;
+          }
+          drawnWeight = weight;
+          drawConnection(f, layerIndex, neuronIndex, inputIndex, weight);
+          changed = true;
+        }
+      }
+    }
+    if (changed)
+    {
+      // connections are drawn under the neurons, so put the neurons back on top
+      for (unsigned long columnIndex = 0; columnIndex <= layersSize; ++columnIndex)
+      {
+        auto neuronsSize = columnSize(columnIndex);
+        for (unsigned long neuronIndex = 0; neuronIndex < neuronsSize; ++neuronIndex)
+        {
+          drawNeuron(f, columnIndex, neuronIndex);
+        }
+      }
+    }
+    nextFrame += refreshPeriod;
+    auto now = std::chrono::steady_clock::now();
+    if (nextFrame < now)
+    {
+      nextFrame = now;
+    }
+    std::this_thread::sleep_until(nextFrame);
+  }
+  fenster_close(&f);
+};
+
+void NetworkVisualizer::drawConnection(::fenster& f, const unsigned long& layerIndex,
+                                       const unsigned long& neuronIndex, const unsigned long& inputIndex,
+                                       const long double& weight)
+{
+  auto start = neuronPosition(layerIndex, inputIndex);
+  auto end = neuronPosition(layerIndex + 1, neuronIndex);
+  auto intensity = uint32_t(0x20 + std::tanh(std::abs(weight)) * 0xdf);
+  uint32_t color = weight >= 0 ? intensity << 8 : intensity << 16;
+  rasterLine(&f, std::get<0>(start), std::get<1>(start), std::get<0>(end), std::get<1>(end), color);
+};
+
+void NetworkVisualizer::drawNeuron(::fenster& f, const unsigned long& columnIndex, const unsigned long& neuronIndex)
+{
+  auto position = neuronPosition(columnIndex, neuronIndex);
+  rasterCircle(&f, std::get<0>(position), std::get<1>(position), 6, 0x00ffffff);
+};
+
+std::pair<int, int> NetworkVisualizer::neuronPosition(const unsigned long& columnIndex,
+                                                      const unsigned long& neuronIndex)
+{
+  auto columnsSize = frontWeights.size() + 1;
+  auto neuronsSize = columnSize(columnIndex);
+  int x = int(width * (columnIndex + 1) / (columnsSize + 1));
+  int y = int(height * (neuronIndex + 1) / (neuronsSize + 1));
+  return {x, y};
+};
+
+unsigned long NetworkVisualizer::columnSize(const unsigned long& columnIndex)
+{
+  if (frontWeights.empty())
+  {
+    return 0;
+  }
+  if (columnIndex == 0)
+  {
+    return frontWeights[0].empty() ? 0 : frontWeights[0][0].size();
+  }
+  return frontWeights[columnIndex - 1].size();
+};
@@ -0,0 +1,146 @@
+/*
+ */
+#include <ObservationNormalizer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+using namespace pong;
+/*
+ */
+ObservationNormalizer::ObservationNormalizer(const Mode& mode, const float& windowWidth, const float& windowHeight):
+  mode(mode),
+  storedMode(mode)
+{
+  long double diagonal = std::sqrt((long double)windowWidth * windowWidth + (long double)windowHeight * windowHeight);
+  long double halfWidth = windowWidth / 2;
+  long double halfHeight = windowHeight / 2;
+  // side, distanceToBall, heightOfBat, ballVelocityX/Y, ballX/Y, hitPointX/Y
+  offsets = {0.5, diagonal / 2, halfHeight, 0, 0, halfWidth, halfHeight, halfWidth, halfHeight};
+  scales = {0.5, diagonal / 2, halfHeight, 8, 8, halfWidth, halfHeight, halfWidth, halfHeight};
+};
+
+void ObservationNormalizer::clearStatistics()
+{
+  count = 0;
+  means = {};
+  m2s = {};
+};
+
+void ObservationNormalizer::update(const std::vector<long double>& input)
+{
+  ++count;
+  for (unsigned long inputIndex = 0; inputIndex < inputsSize; ++inputIndex)
+  {
+    auto& value = input[inputIndex];
+    auto& mean = means[inputIndex];
+    auto delta = value - mean;
+    mean += delta / count;
+    m2s[inputIndex] += delta * (value - mean);
+  }
+};
+
+/*
+ * Combines running statistics gathered separately (Chan et al. parallel variance)
+ */
+void ObservationNormalizer::merge(const ObservationNormalizer& other)
+{
+  if (!other.count)
+  {
+    return;
+  }
+  auto total = count + other.count;
+  for (unsigned long inputIndex = 0; inputIndex < inputsSize; ++inputIndex)
+  {
+    auto delta = other.means[inputIndex] - means[inputIndex];
+    means[inputIndex] += delta * other.count / total;
+    m2s[inputIndex] += other.m2s[inputIndex] + delta * delta * count * other.count / total;
+  }
+  count = total;
+};
+
+void ObservationNormalizer::normalize(std::vector<long double>& input) const
+{
+  bool useRunningStatistics = mode == RunningStatistics && count > 1;
+  for (unsigned long inputIndex = 0; inputIndex < inputsSize; ++inputIndex)
+  {
+    auto& value = input[inputIndex];
+    if (useRunningStatistics)
+    {
+      auto variance = m2s[inputIndex] / (count - 1);
+      value = (value - means[inputIndex]) / std::sqrt(std::max(variance, (long double)1e-6));
+    }
+    else
+    {
+      value = (value - offsets[inputIndex]) / scales[inputIndex];
+    }
+    value = std::clamp(value, -clampLimit, clampLimit);
+  }
+};
+
+/*
+ * Layout: uint32 mode, uint32 inputsSize, uint64 count, double means[inputsSize], double m2s[inputsSize]
+ */
+void ObservationNormalizer::serialize(std::string& bytes) const
+{
+  auto append = [&](const void* data, const unsigned long& size)
+  {
+    bytes.append((const char*)data, size);
+  };
+  uint32_t modeValue = mode;
+  uint32_t inputsSizeValue = inputsSize;
+  uint64_t countValue = count;
+  append(&modeValue, sizeof(modeValue));
+  append(&inputsSizeValue, sizeof(inputsSizeValue));
+  append(&countValue, sizeof(countValue));
+  for (auto& mean : means)
+  {
+    double meanValue = mean;
+    append(&meanValue, sizeof(meanValue));
+  }
+  for (auto& m2 : m2s)
+  {
+    double m2Value = m2;
+    append(&m2Value, sizeof(m2Value));
+  }
+};
+
+bool ObservationNormalizer::deserialize(const char* bytes, const unsigned long& size)
+{
+  uint32_t modeValue;
+  uint32_t inputsSizeValue;
+  uint64_t countValue;
+  const unsigned long expectedSize = sizeof(modeValue) + sizeof(inputsSizeValue) + sizeof(countValue) +
+    2 * inputsSize * sizeof(double);
+  if (size < expectedSize)
+  {
+    return false;
+  }
+  auto read = [&](void* data, const unsigned long& dataSize)
+  {
+    memcpy(data, bytes, dataSize);
+    bytes += dataSize;
+  };
+  read(&modeValue, sizeof(modeValue));
+  read(&inputsSizeValue, sizeof(inputsSizeValue));
+  if (inputsSizeValue != inputsSize || modeValue > RunningStatistics)
+  {
+    return false;
+  }
+  read(&countValue, sizeof(countValue));
+  storedMode = Mode(modeValue);
+  count = countValue;
+  for (auto& mean : means)
+  {
+    double meanValue;
+    read(&meanValue, sizeof(meanValue));
+    mean = meanValue;
+  }
+  for (auto& m2 : m2s)
+  {
+    double m2Value;
+    read(&m2Value, sizeof(m2Value));
+    m2 = m2Value;
+  }
+  return true;
+};
@@ -0,0 +1,200 @@
+/*
+ */
+#include <PolicyGradient.hpp>
+#include <AINetwork.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+using namespace pong;
+using namespace zeuron;
+/*
+ */
+PolicyGradientTrainer::Worker::Worker(const ObservationNormalizer& statistics):
+  statistics(statistics)
+{
+};
+
+PolicyGradientTrainer::PolicyGradientTrainer(std::shared_ptr<NeuralNetwork>& network, std::mutex& networkMutex,
+                                             ObservationNormalizer& normalizer,
+                                             const PolicyGradientSettings& settings):
+  settings(settings),
+  network(network),
+  networkMutex(networkMutex),
+  normalizer(normalizer),
+  rallySteps(settings.matchesSize),
+  workers(std::max(settings.threadsSize, 1ul), Worker(normalizer)),
+  random(settings.matchesSize)
+{
+  this->settings.threadsSize = workers.size();
+  matches.reserve(settings.matchesSize);
+  for (unsigned long matchIndex = 0; matchIndex < settings.matchesSize; ++matchIndex)
+  {
+    matches.push_back(std::make_unique<HeadlessMatch>(960, 540, matchIndex + 1));
+    matches.back()->publishSnapshots = settings.publishSnapshots;
+  }
+};
+
+PolicyBatchStats PolicyGradientTrainer::runBatch()
+{
+  std::unique_lock lock(networkMutex);
+  auto networkStream = network->serialize();
+  ObservationNormalizer frozenNormalizer = normalizer;
+  lock.unlock();
+  std::vector<std::thread> threads;
+  threads.reserve(workers.size());
+  for (unsigned long workerIndex = 0; workerIndex < workers.size(); ++workerIndex)
+  {
+    threads.emplace_back(&PolicyGradientTrainer::rollout, this, workerIndex, networkStream.bytes.get(),
+                         (unsigned long)networkStream.bytesSize, std::cref(frozenNormalizer));
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  PolicyBatchStats stats;
+  long double returnsSum = 0;
+  long double returnsSquaresSum = 0;
+  for (auto& worker : workers)
+  {
+    stats.steps += worker.steps.size();
+    stats.rallies += worker.rallies;
+    stats.hits += worker.hits;
+    returnsSum += worker.returnsSum;
+    returnsSquaresSum += worker.returnsSquaresSum;
+  }
+  ++batches;
+  if (!stats.steps || stopping)
+  {
+    return stats;
+  }
+  stats.meanReturn = returnsSum / stats.steps;
+  auto variance = returnsSquaresSum / stats.steps - stats.meanReturn * stats.meanReturn;
+  update(stats.meanReturn, std::sqrt(std::max(variance, (long double)1e-6)), networkStream.bytes.get(),
+         networkStream.bytesSize);
+  return stats;
+};
+
+void PolicyGradientTrainer::rollout(const unsigned long& workerIndex, const char* networkBytes,
+                                    const unsigned long& networkSize, const ObservationNormalizer& frozenNormalizer)
+{
+  auto replica = copyAINetwork(networkBytes, networkSize);
+  auto& worker = workers[workerIndex];
+  worker.statistics = frozenNormalizer;
+  worker.statistics.clearStatistics();
+  worker.steps.clear();
+  worker.rallies = 0;
+  worker.hits = 0;
+  worker.returnsSum = 0;
+  worker.returnsSquaresSum = 0;
+  std::mt19937 random(batches * workers.size() + workerIndex);
+  std::vector<long double> input(ObservationNormalizer::inputsSize);
+  for (unsigned long tick = 0; tick < settings.ticksPerBatch && !stopping.load(std::memory_order_relaxed); ++tick)
+  {
+    for (auto matchIndex = workerIndex; matchIndex < matches.size(); matchIndex += workers.size())
+    {
+      auto& match = *matches[matchIndex];
+      auto& sidesSteps = rallySteps[matchIndex];
+      for (unsigned long side = 0; side < 2 && match.state.tick % settings.decisionInterval == 0; ++side)
+      {
+        bool leftSide = side == 0;
+        observeMatch(match.state, leftSide, leftSide ? match.leftBatX : match.rightBatX, match.batHeight, input);
+        worker.statistics.update(input);
+        frozenNormalizer.normalize(input);
+        replica->feedforward(input);
+        const auto& outputs = replica->getOutputs();
+        PolicyStep step;
+        std::copy(input.begin(), input.end(), step.observation.begin());
+        (leftSide ? match.leftBatVelocityY : match.rightBatVelocityY) =
+          samplePolicyAction(outputs[0], outputs[1], random, step.actions);
+        step.reward = 0;
+        sidesSteps[side].push_back(step);
+      }
+      auto event = match.step();
+      // rewards go to the decision that was being held when the event happened
+      if (sidesSteps[0].empty())
+      {
+        continue;
+      }
+      if (event == LeftBatHit || event == RightBatHit)
+      {
+        sidesSteps[event == LeftBatHit ? 0 : 1].back().reward += settings.hitReward;
+        ++worker.hits;
+      }
+      else if (event == LeftScored || event == RightScored)
+      {
+        auto winner = event == LeftScored ? 0 : 1;
+        sidesSteps[winner].back().reward += settings.scoreReward;
+        sidesSteps[1 - winner].back().reward -= settings.scoreReward;
+        ++worker.rallies;
+        endRally(worker, sidesSteps[0]);
+        endRally(worker, sidesSteps[1]);
+      }
+      else if (sidesSteps[0].size() >= settings.maxRallySteps)
+      {
+        endRally(worker, sidesSteps[0]);
+        endRally(worker, sidesSteps[1]);
+        match.serve();
+      }
+    }
+  }
+};
+
+/*
+ * Turns the rally's rewards into discounted returns and hands its steps to the batch
+ */
+void PolicyGradientTrainer::endRally(Worker& worker, std::vector<PolicyStep>& steps)
+{
+  long double discountedReturn = 0;
+  for (auto stepIterator = steps.rbegin(); stepIterator != steps.rend(); ++stepIterator)
+  {
+    discountedReturn = stepIterator->reward + settings.discount * discountedReturn;
+    stepIterator->reward = discountedReturn;
+    worker.returnsSum += discountedReturn;
+    worker.returnsSquaresSum += discountedReturn * discountedReturn;
+  }
+  worker.steps.insert(worker.steps.end(), steps.begin(), steps.end());
+  steps.clear();
+};
+
+void PolicyGradientTrainer::update(const long double& meanReturn, const long double& returnDeviation,
+                                   const char* networkBytes, const unsigned long& networkSize)
+{
+  // consecutive steps of a rally are strongly correlated, applied in order they drag the policy along with them
+  updateOrder.clear();
+  for (auto& worker : workers)
+  {
+    for (auto& step : worker.steps)
+    {
+      updateOrder.push_back(&step);
+    }
+  }
+  std::shuffle(updateOrder.begin(), updateOrder.end(), random);
+  auto replicaPointer = copyAINetwork(networkBytes, networkSize);
+  auto& replica = *replicaPointer;
+  std::vector<long double> input(ObservationNormalizer::inputsSize);
+  std::vector<long double> targets(2);
+  for (auto stepPointer : updateOrder)
+  {
+    auto& step = *stepPointer;
+    std::copy(step.observation.begin(), step.observation.end(), input.begin());
+    replica.feedforward(input);
+    const auto& outputs = replica.getOutputs();
+    auto advantage = (step.reward - meanReturn) / returnDeviation;
+    for (unsigned long outputIndex = 0; outputIndex < 2; ++outputIndex)
+    {
+      auto probability = outputs[outputIndex];
+      targets[outputIndex] = std::clamp(
+        probability + settings.advantageScale * advantage * (step.actions[outputIndex] - probability),
+        (long double)0, (long double)1);
+    }
+    replica.backpropagate(targets);
+  }
+  std::lock_guard lock(networkMutex);
+  for (auto& worker : workers)
+  {
+    normalizer.merge(worker.statistics);
+  }
+  // readers only dereference network under the lock, so the old one is freed with replicaPointer after unlocking
+  network.swap(replicaPointer);
+};
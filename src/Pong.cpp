@@ -8,7 +8,16 @@
 #include <NeuralNetwork.hpp>
 #include <fstream>
 #include <ByteStream.hpp>
-#include <Visualizer.hpp>
+#include <NetworkVisualizer.hpp>
+#include <ObservationNormalizer.hpp>
+#include <charconv>
+#include <DecisionCache.hpp>
+#include <MatchView.hpp>
+#include <Raster.hpp>
+#include <AINetwork.hpp>
+#include <Dataset.hpp>
+#include <TrainingView.hpp>
+#include <cstring>
 using namespace pong;
 using namespace zeuron;
 using namespace bs;
@@ -17,17 +26,106 @@ std::random_device _rd;
 std::mt19937 _mt19937(_rd());
 /*
  */
-std::shared_ptr<NeuralNetwork> loadOrCreateAINetwork();
 void saveAINetwork();
 std::mutex aiNetworkMutex;
 std::shared_ptr<NeuralNetwork> aiNetwork;
-
-int main()
-{
-  aiNetwork = loadOrCreateAINetwork();
-  Visualizer visualizer(*aiNetwork, 640, 480);
-  PongGame game(960, 540);
+std::atomic<AINetworkTraining> aiNetworkTraining = SupervisedTraining;
+std::atomic<unsigned long long> aiNetworkGeneration = 0;
+DecisionCache::Mode decisionCacheMode = DecisionCache::Cache;
+std::unique_ptr<NetworkVisualizer> networkVisualizer;
+ObservationNormalizer observationNormalizer(ObservationNormalizer::RunningStatistics, 960, 540);
+std::shared_ptr<DatasetWriter> datasetWriter;
+unsigned long trainMatchesSize = 64;
+
+int main(int argc, char **argv)
+{
+  AINetworkTraining training;
+  aiNetwork = loadOrCreateAINetwork("pong.nrl", observationNormalizer, training);
+  aiNetworkTraining = training;
+  int targetFPS = 60;
+  int idleFPS = 10;
+  bool reportFrameStats = false;
+  for (int argIndex = 1; argIndex < argc; ++argIndex)
+  {
+    if (!strcmp(argv[argIndex], "--visualize"))
+    {
+      networkVisualizer = std::make_unique<NetworkVisualizer>(*aiNetwork, 640, 480);
+    }
+    else if (!strcmp(argv[argIndex], "--fixed-scaling"))
+    {
+      observationNormalizer.mode = ObservationNormalizer::PlayAreaScaling;
+    }
+    else if (!strcmp(argv[argIndex], "--decision-cache=off"))
+    {
+      decisionCacheMode = DecisionCache::Off;
+    }
+    else if (!strcmp(argv[argIndex], "--decision-cache=onchange"))
+    {
+      decisionCacheMode = DecisionCache::OnChange;
+    }
+    else if (!strncmp(argv[argIndex], "--fps=", 6))
+    {
+      // the simulation steps once per frame, so this also scales game speed and Train AI throughput
+      targetFPS = atoi(argv[argIndex] + 6);
+    }
+    else if (!strncmp(argv[argIndex], "--idle-fps=", 11))
+    {
+      idleFPS = atoi(argv[argIndex] + 11);
+    }
+    else if (!strcmp(argv[argIndex], "--stats"))
+    {
+      reportFrameStats = true;
+    }
+    else if (!strncmp(argv[argIndex], "--train-matches=", 16))
+    {
+      trainMatchesSize = std::clamp(atol(argv[argIndex] + 16), 1l, (long)MatchGridEntity::maxMatchesSize);
+    }
+    else if (!strncmp(argv[argIndex], "--record=", 9))
+    {
+      try
+      {
+        datasetWriter = std::make_shared<DatasetWriter>(argv[argIndex] + 9);
+      }
+      catch (const std::exception&)
+      {
+        std::cerr << "Error: Unable to open " << argv[argIndex] + 9 << " for recording.\n";
+        return 1;
+      }
+    }
+    else if (!strcmp(argv[argIndex], "--trace"))
+    {
+      Tracer::enable();
+      std::cout << "tracing to pong.trace.json, keeping the last " << TraceBuffer::capacity
+        << " events of each thread" << std::endl;
+    }
+  }
+  warnOnScalingChange(observationNormalizer, "pong.nrl");
+  if (targetFPS != 60)
+  {
+    std::cout << "the game advances one tick per frame, --fps=" << targetFPS << " runs it at " << targetFPS / 60.0
+      << "x speed" << std::endl;
+  }
+  {
+    // destroying the game destroys its scene, which joins the AI and training threads
+    PongGame game(960, 540, targetFPS, idleFPS, reportFrameStats);
+  }
+  {
+    // publishers check networkVisualizer under aiNetworkMutex, so none can be inside publish() once this is held
+    std::lock_guard lock(aiNetworkMutex);
+    networkVisualizer.reset();
+  }
+  if (datasetWriter)
+  {
+    datasetWriter->close();
+    std::cout << "recorded " << datasetWriter->writtenRecords << " records, dropped "
+      << datasetWriter->droppedRecords << std::endl;
+    datasetWriter.reset();
+  }
   saveAINetwork();
+  if (Tracer::enabled)
+  {
+    Tracer::exportChromeTrace("pong.trace.json");
+  }
 };
 
 ButtonEntity::ButtonEntity(anex::IGame& game,
@@ -57,21 +155,36 @@ ButtonEntity::ButtonEntity(anex::IGame& game,
 
 void ButtonEntity::render()
 {
+  TraceScope renderScope("ButtonEntity::render");
   auto &fensterGame = (FensterGame &)game;
   uint32_t borderColor = selected ? 0x00999999 : 0x00555555;
   uint32_t bgColor = selected ? 0x00222222 : 0x00000000;
-  fenster_rect(fensterGame.f, x, y, width, height, borderColor);
-  fenster_rect(fensterGame.f, x + borderWidth, y + borderWidth, width - borderWidth * 2, height - borderWidth * 2,
-               bgColor);
+  rasterFrame(fensterGame.f, x, y, width, height, borderWidth, borderColor);
+  rasterRect(fensterGame.f, x + borderWidth, y + borderWidth, width - borderWidth * 2, height - borderWidth * 2,
+             bgColor);
   fenster_text(fensterGame.f, x + width / 2 - std::get<0>(textBounds) / 2, y + height / 2 - std::get<1>(textBounds) / 2,
                text, scale, 0x00ffffff);
 };
 
+FrameEntity::FrameEntity(anex::IGame& game):
+  IEntity(game)
+{
+};
+
+void FrameEntity::render()
+{
+  ((PongGame &)game).onFrame();
+};
+
 /*
  */
-PongGame::PongGame(const int& windowWidth, const int& windowHeight):
-  FensterGame(windowWidth, windowHeight)
+PongGame::PongGame(const int& windowWidth, const int& windowHeight, const int& targetFPS, const int& idleFPS,
+                   const bool& reportFrameStats):
+  FensterGame(windowWidth, windowHeight),
+  framePacer(targetFPS, idleFPS),
+  reportFrameStats(reportFrameStats)
 {
+  TraceScope sceneScope("Scene switch: MainMenuScene");
   setIScene(std::make_shared<MainMenuScene>(*this));
   escKeyId = addKeyHandler(27, std::bind(&PongGame::onEscape, this, std::placeholders::_1));
 };
@@ -84,37 +197,77 @@ void PongGame::onEscape(const bool& pressed)
   }
 };
 
+void PongGame::onFrame()
+{
+  {
+    TraceScope pacingScope("Frame pacing");
+    framePacer.pace();
+  }
+  if (framePacer.updateStats())
+  {
+    Tracer::counter("FPS", (long long)framePacer.achievedFPS);
+    Tracer::counter("CPU %", (long long)framePacer.cpuPercent);
+    if (reportFrameStats)
+    {
+      std::cout << "fps: " << framePacer.achievedFPS << " cpu: " << framePacer.cpuPercent << "%"
+        << (framePacer.idle ? " (idle)" : "") << std::endl;
+    }
+  }
+  if (!Tracer::enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  auto now = Tracer::now();
+  if (frameStart)
+  {
+    Tracer::complete("Frame", frameStart, now);
+  }
+  else
+  {
+    Tracer::setThreadName("Render");
+  }
+  frameStart = now;
+};
+
 MainMenuScene::MainMenuScene(anex::IGame& game):
   IScene(game),
   borderWidth(4),
   padding(4),
   playerVsAIButton(std::make_shared<ButtonEntity>(game, "Player vs AI", 0, 0, int(game.windowWidth / 1.5),
-                                                  game.windowHeight / 5, borderWidth, padding, true,
+                                                  game.windowHeight / 6, borderWidth, padding, true,
                                                   std::bind(&MainMenuScene::onPlayerVsAIEnter, this))),
   trainAIButton(std::make_shared<ButtonEntity>(game, "Train AI", 0, 0, int(game.windowWidth / 1.5),
-                                               game.windowHeight / 5, borderWidth, padding, false,
+                                               game.windowHeight / 6, borderWidth, padding, false,
                                                std::bind(&MainMenuScene::onTrainAIEnter, this))),
+  tiledTrainAIButton(std::make_shared<ButtonEntity>(game, "Train AI (Tiled)", 0, 0, int(game.windowWidth / 1.5),
+                                                    game.windowHeight / 6, borderWidth, padding, false,
+                                                    std::bind(&MainMenuScene::onTiledTrainAIEnter, this))),
   playerVsPlayerButton(std::make_shared<ButtonEntity>(game, "Player vs Player", 0, 0,
-                                                      int(game.windowWidth / 1.5), game.windowHeight / 5,
+                                                      int(game.windowWidth / 1.5), game.windowHeight / 6,
                                                       borderWidth, padding, false,
                                                       std::bind(&MainMenuScene::onPlayerVsPlayerEnter, this))),
   exitButton(std::make_shared<ButtonEntity>(game, "Exit", 0, 0, int(game.windowWidth / 1.5),
-                                            game.windowHeight / 5, borderWidth, padding, false,
+                                            game.windowHeight / 6, borderWidth, padding, false,
                                             std::bind(&MainMenuScene::onExitEnter, this))),
-  buttonsList({playerVsAIButton, trainAIButton, playerVsPlayerButton, exitButton})
+  buttonsList({playerVsAIButton, trainAIButton, tiledTrainAIButton, playerVsPlayerButton, exitButton})
 {
+  addEntity(std::make_shared<FrameEntity>(game));
   addEntity(playerVsAIButton);
   addEntity(trainAIButton);
+  addEntity(tiledTrainAIButton);
   addEntity(playerVsPlayerButton);
   addEntity(exitButton);
   positionButtons();
   upKeyId = game.addKeyHandler(17, std::bind(&MainMenuScene::onUpKey, this, std::placeholders::_1));
   downKeyId = game.addKeyHandler(18, std::bind(&MainMenuScene::onDownKey, this, std::placeholders::_1));
   enterKeyId = game.addKeyHandler(10, std::bind(&MainMenuScene::onEnterKey, this, std::placeholders::_1));
+  // nothing on the menu animates, so it can drop to the idle frame rate between key presses
+  ((PongGame &)game).framePacer.setIdleEligible(true);
 };
 
 MainMenuScene::~MainMenuScene()
 {
+  ((PongGame &)game).framePacer.setIdleEligible(false);
   game.removeKeyHandler(17, upKeyId);
   game.removeKeyHandler(18, downKeyId);
 };
@@ -151,6 +304,7 @@ void MainMenuScene::positionButtons()
 
 void MainMenuScene::onUpKey(const bool& pressed)
 {
+  ((PongGame &)game).framePacer.wake();
   if (pressed)
   {
     auto buttonsListSize = buttonsList.size();
@@ -178,6 +332,7 @@ void MainMenuScene::onUpKey(const bool& pressed)
 
 void MainMenuScene::onDownKey(const bool& pressed)
 {
+  ((PongGame &)game).framePacer.wake();
   if (pressed)
   {
     auto buttonsListSize = buttonsList.size();
@@ -205,6 +360,7 @@ void MainMenuScene::onDownKey(const bool& pressed)
 
 void MainMenuScene::onEnterKey(const bool& pressed)
 {
+  ((PongGame &)game).framePacer.wake();
   if (pressed)
   {
     auto buttonsListSize = buttonsList.size();
@@ -223,30 +379,59 @@ void MainMenuScene::onEnterKey(const bool& pressed)
 
 void MainMenuScene::onPlayerVsAIEnter()
 {
+  TraceScope sceneScope("Scene switch: PongScene");
   auto pongScenePointer = std::dynamic_pointer_cast<PongScene>(game.setIScene(std::make_shared<PongScene>(
     game,
     std::make_shared<AIBat>(game, Bat::Left),
     std::make_shared<PlayerBat>(game, Bat::Right, PlayerBat::UpDown)
   )));
   auto aiLeftBatPointer = std::dynamic_pointer_cast<AIBat>(pongScenePointer->leftBat);
-  aiLeftBatPointer->startActivation(pongScenePointer);
+  aiLeftBatPointer->startActivation(*pongScenePointer);
 };
 
 void MainMenuScene::onTrainAIEnter()
 {
+  TraceScope sceneScope("Scene switch: PongScene");
+  if (aiNetworkTraining == PolicyGradientTraining)
+  {
+    std::cout << "pong.nrl is policy-trained, so Train AI only plays it; use Train AI (Tiled) to keep training it"
+      << std::endl;
+  }
   auto pongScenePointer = std::dynamic_pointer_cast<PongScene>(game.setIScene(std::make_shared<PongScene>(
     game,
     std::make_shared<AIBat>(game, Bat::Left),
     std::make_shared<AIBat>(game, Bat::Right)
   )));
   auto aiLeftBatPointer = std::dynamic_pointer_cast<AIBat>(pongScenePointer->leftBat);
-  aiLeftBatPointer->startActivation(pongScenePointer);
+  aiLeftBatPointer->startActivation(*pongScenePointer);
   auto aiRightBatPointer = std::dynamic_pointer_cast<AIBat>(pongScenePointer->rightBat);
-  aiRightBatPointer->startActivation(pongScenePointer);
+  aiRightBatPointer->startActivation(*pongScenePointer);
+};
+
+void MainMenuScene::onTiledTrainAIEnter()
+{
+  TraceScope sceneScope("Scene switch: TrainingGridScene");
+  PolicyGradientSettings settings;
+  settings.matchesSize = trainMatchesSize;
+  settings.publishSnapshots = true;
+  // leave a core for the render thread
+  settings.threadsSize = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  game.setIScene(std::make_shared<TrainingGridScene>(game, aiNetwork, aiNetworkMutex, observationNormalizer,
+                                                     settings, []
+  {
+    aiNetworkTraining = PolicyGradientTraining;
+    aiNetworkGeneration.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(aiNetworkMutex);
+    if (networkVisualizer)
+    {
+      networkVisualizer->publish(*aiNetwork);
+    }
+  }));
 };
 
 void MainMenuScene::onPlayerVsPlayerEnter()
 {
+  TraceScope sceneScope("Scene switch: PongScene");
   game.setIScene(std::make_shared<PongScene>(
     game,
     std::make_shared<PlayerBat>(game, Bat::Left, PlayerBat::WS),
@@ -270,13 +455,10 @@ Bat::Bat(anex::IGame& game, const Bat::Side& side):
 
 void Bat::render()
 {
+  TraceScope renderScope("Bat::render");
   auto &fensterGame = (FensterGame &)game;
-  if ((velocityY < 0 && y - height / 2 > 44) || (velocityY > 0 && y + height / 2 < game.windowHeight - 44))
-  {
-    y += velocityY;
-  }
-  uint32_t color = side == Bat::Left ? 0x00ff0000 : 0x000000ff;
-  fenster_rect(fensterGame.f, x - 2, y - height / 2, 4, height, color);
+  stepBat(y, velocityY, height, game.windowHeight);
+  drawBat(fensterGame.f, x, y, height, side == Bat::Left ? 0x00ff0000 : 0x000000ff);
 };
 
 void Bat::onUpKey(const bool& pressed)
@@ -294,108 +476,35 @@ Ball::Ball(anex::IGame& game, PongScene& pongScene, const int& radius):
   pongScene(pongScene),
   radius(radius)
 {
+  trajectory.first.reserve(16);
+  bouncesScratch.reserve(16);
   reset();
 };
 
 void Ball::startMoving()
 {
-  std::uniform_int_distribution<int> distribution(1, 4);
-  auto startingDirection = distribution(_mt19937);
-  switch (startingDirection)
-  {
-  case 1:
-    {
-      velocityX = 4;
-      velocityY = 2;
-      break;
-    };
-  case 2:
-    {
-      velocityX = -4;
-      velocityY = 2;
-      break;
-    };
-  case 3:
-    {
-      velocityX = 4;
-      velocityY = -2;
-      break;
-    };
-  case 4:
-    {
-      velocityX = -4;
-      velocityY = -2;
-      break;
-    };
-  }
-}
-
+  serveBall(_mt19937, velocityX, velocityY);
+};
 
 void Ball::render()
 {
+  TraceScope renderScope("Ball::render");
   auto &fensterGame = (FensterGame &)game;
-  x += velocityX;
-  y += velocityY;
-  if (y <= 40 || y >= game.windowHeight - 40)
-  {
-    velocityY = -velocityY;
-  }
-  else if (x <= 28 || x >= game.windowWidth - 28)
+  auto& leftBat = *pongScene.leftBat;
+  auto& rightBat = *pongScene.rightBat;
+  auto event = stepBall(x, y, velocityX, velocityY, leftBat.y, leftBat.velocityY, rightBat.y, rightBat.velocityY,
+                        leftBat.height, game.windowWidth, game.windowHeight);
+  if (event == LeftScored || event == RightScored)
   {
-    if (x <= 16)
-    {
-      ++pongScene.rightScore;
-      reset();
-      return;
-    }
-    else if (x == 28)
-    {
-      auto& leftBat = *pongScene.leftBat;
-      if (y < leftBat.y - leftBat.height / 2 || y > leftBat.y + leftBat.height / 2)
-      {
-        goto _draw;
-      }
-      else
-      {
-        velocityY = velocityY + (leftBat.velocityY * 1) / 1;
-      }
-    }
-    else if (x >= game.windowWidth - 16)
-    {
-      ++pongScene.leftScore;
-      reset();
-      return;
-    }
-    else if (x == game.windowWidth - 28)
-    {
-      auto& rightBat = *pongScene.rightBat;
-      if (y < rightBat.y - rightBat.height / 2 || y > rightBat.y + rightBat.height / 2)
-      {
-        goto _draw;
-      }
-      else
-      {
-        velocityY = velocityY + (rightBat.velocityY * 1) / 1;
-      }
-    }
-    else if (x < 28 || x > game.windowWidth - 28)
-    {
-      goto _draw;
-    }
-  _reflect:
-    velocityX = -velocityX;
-  }
-_draw:
-  fenster_circle(fensterGame.f, x, y, radius, 0x00ffffff);
-  trajectory = calculateTrajectory();
-  auto &bounces = std::get<0>(trajectory);
-  auto &finalPosition = std::get<1>(trajectory);
-  for (auto &bounce : bounces)
-  {
-    auto &start = bounce.start;
-    auto &end = bounce.end;
-    fenster_line(fensterGame.f, start.x, start.y, end.x, end.y, 0x0000ff00);
+    ++(event == LeftScored ? pongScene.leftScore : pongScene.rightScore);
+    reset();
+    pongScene.publishSnapshot();
+    return;
   }
+  calculateTrajectory(bouncesScratch, std::get<1>(trajectory));
+  std::swap(std::get<0>(trajectory), bouncesScratch);
+  drawBall(fensterGame.f, x, y, radius, std::get<0>(trajectory));
+  pongScene.publishSnapshot();
 };
 
 void Ball::reset()
@@ -403,74 +512,17 @@ void Ball::reset()
   x = game.windowWidth / 2;
   y = game.windowHeight / 2;
   startMoving();
+  // after a point the next snapshot is published from here, it has to carry the new serve's hit point; the
+  // constructor's reset runs before the scene is wired up and the first render computes it instead
+  if (pongScenePointer)
+  {
+    calculateTrajectory(std::get<0>(trajectory), std::get<1>(trajectory));
+  }
 };
 
-std::pair<std::vector<Bounce>, Point> Ball::calculateTrajectory()
+void Ball::calculateTrajectory(std::vector<Bounce>& bounces, Point& hitPoint)
 {
-  std::vector<Bounce> bounces;
-  Point currentPos = {x, y};
-  Point velocity = {velocityX, velocityY};
-  auto &playArea = pongScenePointer->playArea;
-  float leftWall = playArea.x - (playArea.width / 2);
-  float rightWall = playArea.width + playArea.x - (playArea.width / 2);
-  float topWall = playArea.y - (playArea.height / 2);
-  float bottomWall = playArea.height + playArea.y - (playArea.height / 2);
-
-  while (true)
-  {
-    float timeToVerticalWall = std::numeric_limits<float>::infinity();
-    float timeToHorizontalWall = std::numeric_limits<float>::infinity();
-
-    // Calculate time to the next vertical wall (left or right)
-    if (velocity.x > 0)
-    {
-      timeToVerticalWall = (rightWall - currentPos.x) / velocity.x;
-    }
-    else if (velocity.x < 0)
-    {
-      timeToVerticalWall = (leftWall - currentPos.x) / velocity.x;
-    }
-
-    // Calculate time to the next horizontal wall (top or bottom)
-    if (velocity.y > 0)
-    {
-      timeToHorizontalWall = (bottomWall - currentPos.y) / velocity.y;
-    }
-    else if (velocity.y < 0)
-    {
-      timeToHorizontalWall = (topWall - currentPos.y) / velocity.y;
-    }
-
-    // Determine which wall will be hit first
-    if (timeToVerticalWall < timeToHorizontalWall)
-    {
-      // Ball hits a vertical wall
-      Point nextPos = {currentPos.x + velocity.x * timeToVerticalWall, currentPos.y + velocity.y * timeToVerticalWall};
-      bounces.push_back({currentPos, nextPos});
-
-      // Check if it's a final hit (left or right wall)
-      if (nextPos.x == leftWall || nextPos.x == rightWall)
-      {
-        return {bounces, nextPos};
-      }
-
-      // Update for bounce
-      currentPos = nextPos;
-      velocity.x = -velocity.x; // Reverse horizontal direction
-    }
-    else
-    {
-      // Ball hits a horizontal wall
-      Point nextPos = {
-        currentPos.x + velocity.x * timeToHorizontalWall, currentPos.y + velocity.y * timeToHorizontalWall
-      };
-      bounces.push_back({currentPos, nextPos});
-
-      // Update for bounce
-      currentPos = nextPos;
-      velocity.y = -velocity.y; // Reverse vertical direction
-    }
-  }
+  pong::calculateTrajectory({x, y}, {velocityX, velocityY}, pongScenePointer->playArea, bounces, hitPoint);
 };
 
 Board::Board(anex::IGame& game, PongScene& pongScene):
@@ -486,20 +538,14 @@ Board::Board(anex::IGame& game, PongScene& pongScene):
 
 void Board::render()
 {
+  TraceScope renderScope("Board::render");
   auto &fensterGame = (FensterGame &)game;
-  // white border
-  fenster_rect(fensterGame.f, 8, 32, game.windowWidth - 16, game.windowHeight - 64, 0x00ffffff);
-  // black play area
-  fenster_rect(fensterGame.f, 12, 36, game.windowWidth - 24, game.windowHeight - 72, 0x00000000);
-  // blue left hit rect
-  fenster_rect(fensterGame.f, 12, 36, 4, game.windowHeight - 72, 0x000000ff);
-  // red right hit rect
-  fenster_rect(fensterGame.f, game.windowWidth - 16, 36, 4, game.windowHeight - 72, 0x00ff0000);
-  // left score
-  fenster_text(fensterGame.f, game.windowWidth / 4, 6, std::to_string(pongScene.leftScore).c_str(), 4, 0x00ffffff);
-  // right score
-  fenster_text(fensterGame.f, game.windowWidth / 2 + game.windowWidth / 4, 6,
-               std::to_string(pongScene.rightScore).c_str(), 4, 0x00ffffff);
+  // Board renders first, so this is the render thread's allocations since the last frame
+  auto frameAllocations = frameAllocationScope.threadAllocations();
+  frameAllocationScope.reset();
+  pongScene.frameAllocations.store(frameAllocations, std::memory_order_relaxed);
+  Tracer::counter("Frame allocations", frameAllocations);
+  drawBoard(fensterGame.f, game.windowWidth, game.windowHeight, pongScene.leftScore, pongScene.rightScore);
 };
 
 PlayArea& Board::getPlayArea()
@@ -526,13 +572,16 @@ Countdown::~Countdown()
 
 void Countdown::render()
 {
+  TraceScope renderScope("Countdown::render");
   auto &fensterGame = (FensterGame &)game;
-  fenster_text(fensterGame.f, x - int(1.5 * scale), y - int(2.5 * scale), std::to_string(timer).c_str(), scale,
-               0x00ffffff);
+  char timerText[12];
+  *std::to_chars(timerText, timerText + 11, timer).ptr = 0;
+  fenster_text(fensterGame.f, x - int(1.5 * scale), y - int(2.5 * scale), timerText, scale, 0x00ffffff);
 };
 
 void Countdown::startCountdown()
 {
+  Tracer::setThreadName("Countdown");
   while (timer > 0)
   {
     std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -541,12 +590,15 @@ void Countdown::startCountdown()
       return;
     }
     --timer;
+    Tracer::instant("Countdown tick");
   }
+  TraceScope zeroScope("Countdown zero");
   onZero();
 };
 
 PongScene::PongScene(anex::IGame& game, const std::shared_ptr<Bat>& leftBat, const std::shared_ptr<Bat>& rightBat):
   IScene(game),
+  frameEntity(std::make_shared<FrameEntity>(game)),
   leftBat(leftBat),
   rightBat(rightBat),
   board(std::make_shared<Board>(game, *this)),
@@ -556,6 +608,7 @@ PongScene::PongScene(anex::IGame& game, const std::shared_ptr<Bat>& leftBat, con
   playArea(board->getPlayArea())
 {
   ball->pongScenePointer = this;
+  addEntity(frameEntity);
   addEntity(board);
   addEntity(leftBat);
   addEntity(rightBat);
@@ -565,6 +618,14 @@ PongScene::PongScene(anex::IGame& game, const std::shared_ptr<Bat>& leftBat, con
 PongScene::~PongScene()
 {
   gameStarted = false;
+  // AI threads read this scene until they are joined, and flush their recordings on the way out
+  for (auto& bat : {leftBat, rightBat})
+  {
+    if (auto aiBat = std::dynamic_pointer_cast<AIBat>(bat))
+    {
+      aiBat->stopActivation();
+    }
+  }
 }
 
 void PongScene::onCountdownZero()
@@ -572,6 +633,26 @@ void PongScene::onCountdownZero()
   removeEntity(countdownId);
   ballId = addEntity(ball);
   gameStarted = true;
+  Tracer::instant("Game started");
+};
+
+/*
+ * Called on the render thread after the ball has moved, AI threads read it with snapshot.load()
+ */
+void PongScene::publishSnapshot()
+{
+  snapshot.store({
+    ++tick,
+    ball->x,
+    ball->y,
+    ball->velocityX,
+    ball->velocityY,
+    std::get<1>(ball->trajectory),
+    leftBat->y,
+    rightBat->y,
+    leftScore,
+    rightScore
+  });
 };
 
 PlayerBat::PlayerBat(anex::IGame& game, const Bat::Side& side, const UseKeys& useKeys):
@@ -588,141 +669,89 @@ PlayerBat::PlayerBat(anex::IGame& game, const Bat::Side& side, const UseKeys& us
   );
 };
 
-std::pair<std::shared_ptr<char>, unsigned long> readFileToBuffer(const std::string& filename)
-{
-  std::ifstream file(filename, std::ios::binary | std::ios::ate);
-  if (!file.is_open())
-  {
-    throw std::ios_base::failure("Error: Unable to open file for reading.");
-  }
-  std::streampos fileSize = file.tellg();
-  if (fileSize <= 0)
-  {
-    throw std::ios_base::failure("Error: File is empty or has invalid size.");
-  }
-  unsigned long size = static_cast<unsigned long>(fileSize);
-  std::shared_ptr<char> buffer(new char[size], std::default_delete<char[]>());
-  file.seekg(0, std::ios::beg);
-  file.read(buffer.get(), size);
-  if (!file)
-  {
-    throw std::ios_base::failure("Error: Reading the file failed.");
-  }
-  file.close();
-  return std::make_pair(buffer, size);
-};
-
-void writeBufferToFile(const char* buffer, unsigned long size, const std::string& filename)
-{
-  std::ofstream file(filename, std::ios::binary);
-  if (!file.is_open())
-  {
-    std::cerr << "Error: Unable to open file for writing.\n";
-    return;
-  }
-  file.write(buffer, static_cast<std::streamsize>(size));
-  if (!file)
-  {
-    std::cerr << "Error: Writing to the file failed.\n";
-  }
-  file.close();
-};
-
-std::shared_ptr<NeuralNetwork> loadOrCreateAINetwork()
-{
-  try
-  {
-    auto bytesSizePair = readFileToBuffer("pong.nrl");
-    ByteStream byteStream(std::get<1>(bytesSizePair), std::get<0>(bytesSizePair));
-    return std::make_shared<NeuralNetwork>(byteStream);
-  }
-  catch (...)
-  {
-    return std::make_shared<NeuralNetwork>(
-      9, // Inputs: which side [0 or 1], distance to bat center, height of bat, ballVelocityX/Y, hitPointX/Y
-      std::vector<std::pair<NeuralNetwork::ActivationType, unsigned long>>({
-        {NeuralNetwork::ReLU, 10}, // First hidden layer with ReLU for feature extraction
-        {NeuralNetwork::ReLU, 8}, // Second hidden layer for refinement
-        {NeuralNetwork::Sigmoid, 4}, // Third hidden layer to add non-linearity
-        {NeuralNetwork::Sigmoid, 2} // Output layer: Sigmoid for binary outputs (keyUp, keyDown)
-      }),
-      0.01 // Reduced learning rate for stable convergence
-    );
-  }
-};
-
 void saveAINetwork()
 {
   std::lock_guard lock(aiNetworkMutex);
-  auto nnStream = aiNetwork->serialize();
-  writeBufferToFile(nnStream.bytes.get(), nnStream.bytesSize, "pong.nrl");
+  pong::saveAINetwork(*aiNetwork, observationNormalizer, aiNetworkTraining, "pong.nrl");
 };
 
 AIBat::AIBat(anex::IGame& game, const Bat::Side& side):
-  Bat(game, side)
+  Bat(game, side),
+  controller(aiNetwork, aiNetworkMutex, observationNormalizer, aiNetworkGeneration, decisionCacheMode, _rd())
 {
+  controller.leftSide = side == Bat::Side::Left;
+  controller.batX = x;
+  controller.batHeight = height;
+  controller.onInference = [](NeuralNetwork& network)
+  {
+    if (networkVisualizer)
+    {
+      networkVisualizer->publish(network);
+    }
+  };
 };
 
-void AIBat::startActivation(const std::shared_ptr<PongScene>& pongScenePointer)
+AIBat::~AIBat()
 {
-  this->pongScenePointer = pongScenePointer;
-  activationThread = std::thread(&AIBat::activationFunction, this);
+  stopActivation();
 };
 
-long double distance(const long double& a, const long double& b)
+void AIBat::startActivation(PongScene& pongScene)
 {
-  return std::abs(a - b);
-}
+  pongScenePointer = &pongScene;
+  activationThread = std::thread(&AIBat::activationFunction, this);
+};
 
-long double distance(const std::pair<long double, long double>& point1,
-                     const std::pair<long double, long double>& point2)
+void AIBat::stopActivation()
 {
-  long double dx = point1.first - point2.first;
-  long double dy = point1.second - point2.second;
-  return std::sqrt(dx * dx + dy * dy);
-}
+  stopping = true;
+  if (activationThread.joinable())
+  {
+    activationThread.join();
+  }
+};
 
 void AIBat::activationFunction()
 {
-  long double sideDouble = side == Bat::Side::Left ? 0 : 1;
+  Tracer::setThreadName(side == Bat::Side::Left ? "AIBat left" : "AIBat right");
   auto& pongScene = *pongScenePointer;
-  while (!pongScene.gameStarted)
+  // the first snapshot is published by the ball's first render after the countdown
+  while (!stopping && (!pongScene.gameStarted || !pongScene.snapshot.version()))
   {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
   }
-  auto& ball = *pongScene.ball;
-  auto& aiNetworkRef = *aiNetwork;
-  auto& playArea = pongScene.playArea;
-  while (pongScene.gameStarted)
+  const char *inferencesCounterName = side == Bat::Side::Left ? "AI inferences left" : "AI inferences right";
+  const char *cacheHitsCounterName = side == Bat::Side::Left ? "AI cache hits left" : "AI cache hits right";
+  unsigned long long ticks = 0;
+  unsigned long long lastSnapshotVersion = 0;
+  // set from pong.nrl when activation starts: a policy network is sampled and never backpropagated in game
+  controller.policyNetwork = aiNetworkTraining == PolicyGradientTraining;
+  if (datasetWriter)
   {
-    std::lock_guard lock(aiNetworkMutex);
-    long double distanceToBall = distance({x, y}, {ball.x, ball.y});
-    long double heightOfBat = height;
-    auto &trajectory = ball.trajectory;
-    auto &hitPoint = std::get<1>(trajectory);
-    auto &hitPointX = hitPoint.x;
-    auto &hitPointY = hitPoint.y;
-    std::vector<long double> input({
-      sideDouble, distanceToBall, heightOfBat, ball.velocityX, ball.velocityY, ball.x, ball.y, hitPointX, hitPointY
-    });
-    aiNetworkRef.feedforward(input);
-    auto outputs = aiNetworkRef.getOutputs();
-    if (distance(outputs[0], 1) <= 0.03)
-    {
-      onUpKey(true);
-    }
-    else if (distance(outputs[1], 1) <= 0.03)
+    controller.datasetRecorder = std::make_unique<DatasetRecorder>(datasetWriter);
+  }
+  AllocationScope tickAllocationScope;
+  unsigned long long tickNetworkAllocations = 0;
+  while (pongScene.gameStarted && !stopping)
+  {
+    // one decision per published tick, sleep instead of spinning between them
+    auto snapshotVersion = pongScene.snapshot.version();
+    if (snapshotVersion == lastSnapshotVersion)
     {
-      onDownKey(true);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
     }
-    else
+    lastSnapshotVersion = snapshotVersion;
+    tickAllocations.store(tickAllocationScope.threadAllocations() -
+                          (controller.networkAllocations - tickNetworkAllocations), std::memory_order_relaxed);
+    tickAllocationScope.reset();
+    tickNetworkAllocations = controller.networkAllocations;
+    if ((++ticks & 0xff) == 0)
     {
-      velocityY = 0;
+      Tracer::counter(inferencesCounterName, controller.inferenceCount);
+      Tracer::counter(cacheHitsCounterName, controller.decisionCache.hits);
     }
-    std::vector<long double> expectedOutputs;
-    // auto yDifference = distance(y, hitPointY);
-    auto onSide = (side == Bat::Side::Left ? hitPointX == 12 : hitPointX == 948);
-    expectedOutputs.push_back(!onSide || hitPointY > y ? 0 : 1);
-    expectedOutputs.push_back(!onSide || hitPointY < y ? 0 : 1);
-    aiNetworkRef.backpropagate(expectedOutputs);
+    velocityY = controller.decide(pongScene.snapshot.load());
   }
+  controller.datasetRecorder.reset();
 }
\ No newline at end of file
@@ -0,0 +1,425 @@
+/*
+ * pong_train: trains the pong AI offline from datasets recorded with `pong --record=<file>`, or with --rl by
+ * self-play in headless matches
+ */
+#include <AINetwork.hpp>
+#include <Dataset.hpp>
+#include <FramePacer.hpp>
+#include <PolicyGradient.hpp>
+#include <ByteStream.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace pong;
+using namespace zeuron;
+using namespace bs;
+/*
+ */
+struct TrainOptions
+{
+  std::string networkFilename = "pong.nrl";
+  unsigned long epochs = 1;
+  unsigned long threadsSize = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  bool skipLost = false;
+  ObservationNormalizer::Mode normalizerMode = ObservationNormalizer::RunningStatistics;
+  bool reinforcement = false;
+  unsigned long batches = 100;
+  unsigned long matchesSize = 16;
+  std::vector<std::string> datasetFilenames;
+};
+
+/*
+ * Normalized, row-major records of one chunk, ready to feed to the network
+ */
+struct DecodedChunk
+{
+  unsigned long size = 0;
+  std::vector<long double> observations;
+  std::vector<long double> expectedOutputs;
+};
+
+/*
+ * Bounded hand-off between decode workers and the training thread, buffers are recycled through freeChunks
+ */
+struct DecodeQueue
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::unique_ptr<DecodedChunk>> freeChunks;
+  std::vector<std::unique_ptr<DecodedChunk>> readyChunks;
+  DecodeQueue(const unsigned long& buffersSize)
+  {
+    freeChunks.reserve(buffersSize);
+    readyChunks.reserve(buffersSize);
+    for (unsigned long bufferIndex = 0; bufferIndex < buffersSize; ++bufferIndex)
+    {
+      auto buffer = std::make_unique<DecodedChunk>();
+      buffer->observations.resize(DatasetChunk::capacity * DatasetFormat::observationWidth);
+      buffer->expectedOutputs.resize(DatasetChunk::capacity * DatasetFormat::expectedWidth);
+      freeChunks.push_back(std::move(buffer));
+    }
+  }
+  std::unique_ptr<DecodedChunk> take(std::vector<std::unique_ptr<DecodedChunk>>& from)
+  {
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&]
+    {
+      return !from.empty();
+    });
+    auto buffer = std::move(from.back());
+    from.pop_back();
+    return buffer;
+  }
+  void give(std::vector<std::unique_ptr<DecodedChunk>>& to, std::unique_ptr<DecodedChunk> buffer)
+  {
+    {
+      std::lock_guard lock(mutex);
+      to.push_back(std::move(buffer));
+    }
+    condition.notify_all();
+  }
+};
+
+struct EvaluationResult
+{
+  unsigned long long recordsSize = 0;
+  unsigned long long correct = 0;
+  long double squaredError = 0;
+};
+
+void printUsage()
+{
+  std::cerr << "usage: pong_train [--network=pong.nrl] [--fixed-scaling] [--epochs=N] [--threads=N] [--skip-lost] "
+    "dataset.pds...\n"
+    "       pong_train --rl [--network=pong.nrl] [--fixed-scaling] [--batches=N] [--matches=N] [--threads=N]\n"
+    "dataset epochs backpropagate on one thread, --threads sets the decode and evaluation workers; with --rl it\n"
+    "sets the rollout workers\n";
+};
+
+bool parseOptions(int argc, char **argv, TrainOptions& options)
+{
+  for (int argIndex = 1; argIndex < argc; ++argIndex)
+  {
+    if (!strncmp(argv[argIndex], "--network=", 10))
+    {
+      options.networkFilename = argv[argIndex] + 10;
+    }
+    else if (!strncmp(argv[argIndex], "--epochs=", 9))
+    {
+      options.epochs = std::max(atol(argv[argIndex] + 9), 1l);
+    }
+    else if (!strncmp(argv[argIndex], "--threads=", 10))
+    {
+      options.threadsSize = std::max(atol(argv[argIndex] + 10), 1l);
+    }
+    else if (!strcmp(argv[argIndex], "--skip-lost"))
+    {
+      options.skipLost = true;
+    }
+    else if (!strcmp(argv[argIndex], "--fixed-scaling"))
+    {
+      options.normalizerMode = ObservationNormalizer::PlayAreaScaling;
+    }
+    else if (!strcmp(argv[argIndex], "--rl"))
+    {
+      options.reinforcement = true;
+    }
+    else if (!strncmp(argv[argIndex], "--batches=", 10))
+    {
+      options.batches = std::max(atol(argv[argIndex] + 10), 1l);
+    }
+    else if (!strncmp(argv[argIndex], "--matches=", 10))
+    {
+      options.matchesSize = std::max(atol(argv[argIndex] + 10), 1l);
+    }
+    else if (argv[argIndex][0] == '-')
+    {
+      return false;
+    }
+    else
+    {
+      options.datasetFilenames.push_back(argv[argIndex]);
+    }
+  }
+  return options.reinforcement || !options.datasetFilenames.empty();
+};
+
+/*
+ * Runs body(threadIndex) on threadsSize threads and waits for all of them
+ */
+template <typename Body>
+void parallelFor(const unsigned long& threadsSize, const Body& body)
+{
+  std::vector<std::thread> threads;
+  threads.reserve(threadsSize);
+  for (unsigned long threadIndex = 0; threadIndex < threadsSize; ++threadIndex)
+  {
+    threads.emplace_back(body, threadIndex);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+};
+
+void fitStatistics(const std::vector<const DatasetChunkView*>& chunks, ObservationNormalizer& normalizer,
+                   const unsigned long& threadsSize)
+{
+  std::vector<ObservationNormalizer> partials(threadsSize, normalizer);
+  parallelFor(threadsSize, [&](const unsigned long& threadIndex)
+  {
+    auto& partial = partials[threadIndex];
+    partial.clearStatistics();
+    std::vector<long double> observation(DatasetFormat::observationWidth);
+    for (auto chunkIndex = threadIndex; chunkIndex < chunks.size(); chunkIndex += threadsSize)
+    {
+      auto& chunk = *chunks[chunkIndex];
+      for (unsigned long recordIndex = 0; recordIndex < chunk.size; ++recordIndex)
+      {
+        for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+        {
+          observation[column] = chunk.observations[column][recordIndex];
+        }
+        partial.update(observation);
+      }
+    }
+  });
+  for (auto& partial : partials)
+  {
+    normalizer.merge(partial);
+  }
+};
+
+void decodeChunk(const DatasetChunkView& chunk, const ObservationNormalizer& normalizer, const bool& skipLost,
+                 DecodedChunk& decoded, std::vector<long double>& observation)
+{
+  decoded.size = 0;
+  for (unsigned long recordIndex = 0; recordIndex < chunk.size; ++recordIndex)
+  {
+    if (skipLost && chunk.outcomes[recordIndex] < 0)
+    {
+      continue;
+    }
+    for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+    {
+      observation[column] = chunk.observations[column][recordIndex];
+    }
+    normalizer.normalize(observation);
+    std::copy(observation.begin(), observation.end(),
+              decoded.observations.begin() + decoded.size * DatasetFormat::observationWidth);
+    for (unsigned long column = 0; column < DatasetFormat::expectedWidth; ++column)
+    {
+      decoded.expectedOutputs[decoded.size * DatasetFormat::expectedWidth + column] =
+        chunk.expectedOutputs[column][recordIndex];
+    }
+    ++decoded.size;
+  }
+};
+
+/*
+ * Decode workers turn mapped chunks into normalized rows while this thread runs backprop, the network itself is
+ * only ever touched from here. Backprop is serial: zeuron only exposes weights through serialize(), so there is no
+ * way to average per-thread replicas, and --threads only scales decoding and evaluation.
+ */
+unsigned long long trainEpoch(NeuralNetwork& network, const std::vector<const DatasetChunkView*>& chunks,
+                              const ObservationNormalizer& normalizer, const TrainOptions& options,
+                              DecodeQueue& queue)
+{
+  std::atomic<unsigned long> nextChunk = 0;
+  std::vector<std::thread> decoders;
+  for (unsigned long threadIndex = 0; threadIndex < options.threadsSize; ++threadIndex)
+  {
+    decoders.emplace_back([&]
+    {
+      std::vector<long double> observation(DatasetFormat::observationWidth);
+      while (true)
+      {
+        auto chunkIndex = nextChunk.fetch_add(1);
+        if (chunkIndex >= chunks.size())
+        {
+          return;
+        }
+        auto decoded = queue.take(queue.freeChunks);
+        decodeChunk(*chunks[chunkIndex], normalizer, options.skipLost, *decoded, observation);
+        queue.give(queue.readyChunks, std::move(decoded));
+      }
+    });
+  }
+  unsigned long long trainedRecords = 0;
+  std::vector<long double> input(DatasetFormat::observationWidth);
+  std::vector<long double> expectedOutputs(DatasetFormat::expectedWidth);
+  for (unsigned long chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+  {
+    auto decoded = queue.take(queue.readyChunks);
+    for (unsigned long recordIndex = 0; recordIndex < decoded->size; ++recordIndex)
+    {
+      auto observationRow = decoded->observations.begin() + recordIndex * DatasetFormat::observationWidth;
+      auto expectedRow = decoded->expectedOutputs.begin() + recordIndex * DatasetFormat::expectedWidth;
+      std::copy(observationRow, observationRow + DatasetFormat::observationWidth, input.begin());
+      std::copy(expectedRow, expectedRow + DatasetFormat::expectedWidth, expectedOutputs.begin());
+      network.feedforward(input);
+      network.backpropagate(expectedOutputs);
+    }
+    trainedRecords += decoded->size;
+    queue.give(queue.freeChunks, std::move(decoded));
+  }
+  for (auto& decoder : decoders)
+  {
+    decoder.join();
+  }
+  return trainedRecords;
+};
+
+/*
+ * Each thread scores its shard on its own copy of the network
+ */
+EvaluationResult evaluate(NeuralNetwork& network, const std::vector<const DatasetChunkView*>& chunks,
+                          const ObservationNormalizer& normalizer, const unsigned long& threadsSize)
+{
+  auto networkStream = network.serialize();
+  std::vector<EvaluationResult> partials(threadsSize);
+  parallelFor(threadsSize, [&](const unsigned long& threadIndex)
+  {
+    auto replicaPointer = copyAINetwork(networkStream.bytes.get(), networkStream.bytesSize);
+    auto& replica = *replicaPointer;
+    auto& partial = partials[threadIndex];
+    std::vector<long double> observation(DatasetFormat::observationWidth);
+    for (auto chunkIndex = threadIndex; chunkIndex < chunks.size(); chunkIndex += threadsSize)
+    {
+      auto& chunk = *chunks[chunkIndex];
+      for (unsigned long recordIndex = 0; recordIndex < chunk.size; ++recordIndex)
+      {
+        for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+        {
+          observation[column] = chunk.observations[column][recordIndex];
+        }
+        normalizer.normalize(observation);
+        replica.feedforward(observation);
+        const auto& outputs = replica.getOutputs();
+        bool correct = true;
+        for (unsigned long column = 0; column < DatasetFormat::expectedWidth; ++column)
+        {
+          long double expected = chunk.expectedOutputs[column][recordIndex];
+          auto error = outputs[column] - expected;
+          partial.squaredError += error * error;
+          correct = correct && (outputs[column] >= 0.5) == (expected >= 0.5);
+        }
+        partial.correct += correct;
+        ++partial.recordsSize;
+      }
+    }
+  });
+  EvaluationResult result;
+  for (auto& partial : partials)
+  {
+    result.recordsSize += partial.recordsSize;
+    result.correct += partial.correct;
+    result.squaredError += partial.squaredError;
+  }
+  return result;
+};
+
+int trainReinforcement(const TrainOptions& options)
+{
+  ObservationNormalizer normalizer(options.normalizerMode, 960, 540);
+  AINetworkTraining training;
+  auto network = loadOrCreateAINetwork(options.networkFilename, normalizer, training);
+  warnOnScalingChange(normalizer, options.networkFilename);
+  std::mutex networkMutex;
+  PolicyGradientSettings settings;
+  settings.matchesSize = options.matchesSize;
+  settings.threadsSize = options.threadsSize;
+  PolicyGradientTrainer trainer(network, networkMutex, normalizer, settings);
+  for (unsigned long batch = 0; batch < options.batches; ++batch)
+  {
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart = FramePacer::processCPUSeconds();
+    auto stats = trainer.runBatch();
+    std::chrono::duration<double> wallSeconds = std::chrono::steady_clock::now() - wallStart;
+    auto cpuSeconds = FramePacer::processCPUSeconds() - cpuStart;
+    // every rally ends with exactly one miss
+    auto returnRate = stats.hits + stats.rallies ? double(stats.hits) / (stats.hits + stats.rallies) : 0;
+    std::cout << "batch " << batch + 1 << "/" << options.batches << ": " << stats.steps << " steps, "
+      << stats.rallies << " rallies in " << wallSeconds.count() << "s ("
+      << stats.steps / std::max(wallSeconds.count(), 1e-9) << " steps/s, " << cpuSeconds << " cpu-s), return rate "
+      << returnRate << ", mean return " << double(stats.meanReturn) << std::endl;
+  }
+  saveAINetwork(*network, normalizer, PolicyGradientTraining, options.networkFilename);
+  return 0;
+};
+
+int main(int argc, char **argv)
+{
+  TrainOptions options;
+  if (!parseOptions(argc, argv, options))
+  {
+    printUsage();
+    return 1;
+  }
+  if (options.reinforcement)
+  {
+    return trainReinforcement(options);
+  }
+  std::vector<std::unique_ptr<MappedDataset>> datasets;
+  std::vector<const DatasetChunkView*> chunks;
+  unsigned long long recordsSize = 0;
+  try
+  {
+    for (auto& datasetFilename : options.datasetFilenames)
+    {
+      datasets.push_back(std::make_unique<MappedDataset>(datasetFilename));
+      for (auto& chunk : datasets.back()->chunks)
+      {
+        chunks.push_back(&chunk);
+      }
+      recordsSize += datasets.back()->recordsSize;
+    }
+  }
+  catch (const std::exception& exception)
+  {
+    std::cerr << exception.what() << "\n";
+    return 1;
+  }
+  std::cout << "loaded " << recordsSize << " records in " << chunks.size() << " chunks from "
+    << datasets.size() << " files" << std::endl;
+  ObservationNormalizer normalizer(options.normalizerMode, 960, 540);
+  AINetworkTraining training;
+  auto network = loadOrCreateAINetwork(options.networkFilename, normalizer, training);
+  warnOnScalingChange(normalizer, options.networkFilename);
+  if (training == PolicyGradientTraining)
+  {
+    std::cout << options.networkFilename << " was policy-trained, the dataset labels will retrain it as a "
+      "supervised network" << std::endl;
+  }
+  if (normalizer.mode == ObservationNormalizer::RunningStatistics && !normalizer.count)
+  {
+    // a fresh network has no statistics yet, take them from the whole dataset before the first epoch
+    fitStatistics(chunks, normalizer, options.threadsSize);
+    std::cout << "fitted observation statistics over " << normalizer.count << " records" << std::endl;
+  }
+  DecodeQueue queue(options.threadsSize * 2);
+  std::mt19937 random(std::random_device{}());
+  for (unsigned long epoch = 0; epoch < options.epochs; ++epoch)
+  {
+    std::shuffle(chunks.begin(), chunks.end(), random);
+    auto wallStart = std::chrono::steady_clock::now();
+    auto cpuStart = FramePacer::processCPUSeconds();
+    auto trainedRecords = trainEpoch(*network, chunks, normalizer, options, queue);
+    std::chrono::duration<double> wallSeconds = std::chrono::steady_clock::now() - wallStart;
+    auto cpuSeconds = FramePacer::processCPUSeconds() - cpuStart;
+    auto result = evaluate(*network, chunks, normalizer, options.threadsSize);
+    std::cout << "epoch " << epoch + 1 << "/" << options.epochs << ": " << trainedRecords << " records in "
+      << wallSeconds.count() << "s (" << trainedRecords / std::max(wallSeconds.count(), 1e-9) << " records/s, "
+      << cpuSeconds << " cpu-s), accuracy " << (result.recordsSize ? double(result.correct) / result.recordsSize : 0)
+      << ", mse " << (result.recordsSize ? double(result.squaredError / result.recordsSize) : 0) << std::endl;
+  }
+  saveAINetwork(*network, normalizer, SupervisedTraining, options.networkFilename);
+  return 0;
+};
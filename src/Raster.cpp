@@ -0,0 +1,190 @@
+/*
+ */
+#include <Raster.hpp>
+#include <algorithm>
+#include <cstdlib>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+using namespace pong;
+/*
+ */
+void pong::rasterSpan(uint32_t* pixels, int count, const uint32_t& color)
+{
+#if defined(__AVX2__)
+  auto value = _mm256_set1_epi32((int)color);
+  for (; count >= 16; count -= 16, pixels += 16)
+  {
+    _mm256_storeu_si256((__m256i*)pixels, value);
+    _mm256_storeu_si256((__m256i*)(pixels + 8), value);
+  }
+  if (count >= 8)
+  {
+    _mm256_storeu_si256((__m256i*)pixels, value);
+    count -= 8;
+    pixels += 8;
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  auto value = _mm_set1_epi32((int)color);
+  for (; count >= 16; count -= 16, pixels += 16)
+  {
+    _mm_storeu_si128((__m128i*)pixels, value);
+    _mm_storeu_si128((__m128i*)(pixels + 4), value);
+    _mm_storeu_si128((__m128i*)(pixels + 8), value);
+    _mm_storeu_si128((__m128i*)(pixels + 12), value);
+  }
+  for (; count >= 4; count -= 4, pixels += 4)
+  {
+    _mm_storeu_si128((__m128i*)pixels, value);
+  }
+#elif defined(__ARM_NEON)
+  auto value = vdupq_n_u32(color);
+  for (; count >= 16; count -= 16, pixels += 16)
+  {
+    vst1q_u32(pixels, value);
+    vst1q_u32(pixels + 4, value);
+    vst1q_u32(pixels + 8, value);
+    vst1q_u32(pixels + 12, value);
+  }
+  for (; count >= 4; count -= 4, pixels += 4)
+  {
+    vst1q_u32(pixels, value);
+  }
+#endif
+  for (; count > 0; --count)
+  {
+    *pixels++ = color;
+  }
+};
+
+void pong::rasterRect(::fenster* f, int x, int y, int width, int height, const uint32_t& color)
+{
+  int x1 = std::min(x + width, f->width);
+  int y1 = std::min(y + height, f->height);
+  x = std::max(x, 0);
+  y = std::max(y, 0);
+  if (x >= x1 || y >= y1)
+  {
+    return;
+  }
+  for (auto row = f->buf + y * f->width + x; y < y1; ++y, row += f->width)
+  {
+    rasterSpan(row, x1 - x, color);
+  }
+};
+
+void pong::rasterFrame(::fenster* f, const int& x, const int& y, const int& width, const int& height,
+                       const int& borderWidth, const uint32_t& color)
+{
+  rasterRect(f, x, y, width, borderWidth, color);
+  rasterRect(f, x, y + height - borderWidth, width, borderWidth, color);
+  rasterRect(f, x, y + borderWidth, borderWidth, height - borderWidth * 2, color);
+  rasterRect(f, x + width - borderWidth, y + borderWidth, borderWidth, height - borderWidth * 2, color);
+};
+
+void pong::rasterCircle(::fenster* f, const int& centerX, const int& centerY, const int& radius,
+                        const uint32_t& color)
+{
+  // same coverage as fenster_circle (dx * dx + dy * dy <= r * r), one span per scanline
+  int halfWidth = 0;
+  for (int dy = -radius; dy <= radius; ++dy)
+  {
+    int remaining = radius * radius - dy * dy;
+    while (halfWidth * halfWidth > remaining)
+    {
+      --halfWidth;
+    }
+    while ((halfWidth + 1) * (halfWidth + 1) <= remaining)
+    {
+      ++halfWidth;
+    }
+    rasterRect(f, centerX - halfWidth, centerY + dy, halfWidth * 2 + 1, 1, color);
+  }
+};
+
+/*
+ * Cohen-Sutherland clip to the framebuffer, then Bresenham
+ */
+void pong::rasterLine(::fenster* f, int x0, int y0, int x1, int y1, const uint32_t& color)
+{
+  const int maxX = f->width - 1;
+  const int maxY = f->height - 1;
+  auto outCode = [&](const int& x, const int& y)
+  {
+    return (x < 0 ? 1 : 0) | (x > maxX ? 2 : 0) | (y < 0 ? 4 : 0) | (y > maxY ? 8 : 0);
+  };
+  auto code0 = outCode(x0, y0);
+  auto code1 = outCode(x1, y1);
+  while (code0 | code1)
+  {
+    if (code0 & code1)
+    {
+      return;
+    }
+    auto code = code0 ? code0 : code1;
+    long long dx = x1 - x0;
+    long long dy = y1 - y0;
+    int x, y;
+    if (code & 8)
+    {
+      x = int(x0 + dx * (maxY - y0) / dy);
+      y = maxY;
+    }
+    else if (code & 4)
+    {
+      x = int(x0 + dx * (0 - y0) / dy);
+      y = 0;
+    }
+    else if (code & 2)
+    {
+      y = int(y0 + dy * (maxX - x0) / dx);
+      x = maxX;
+    }
+    else
+    {
+      y = int(y0 + dy * (0 - x0) / dx);
+      x = 0;
+    }
+    if (code == code0)
+    {
+      x0 = x;
+      y0 = y;
+      code0 = outCode(x0, y0);
+    }
+    else
+    {
+      x1 = x;
+      y1 = y;
+      code1 = outCode(x1, y1);
+    }
+  }
+  if (y0 == y1)
+  {
+    rasterSpan(f->buf + y0 * f->width + std::min(x0, x1), std::abs(x1 - x0) + 1, color);
+    return;
+  }
+  int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int error = dx + dy;
+  while (true)
+  {
+    f->buf[y0 * f->width + x0] = color;
+    if (x0 == x1 && y0 == y1)
+    {
+      break;
+    }
+    int error2 = 2 * error;
+    if (error2 >= dy)
+    {
+      error += dy;
+      x0 += sx;
+    }
+    if (error2 <= dx)
+    {
+      error += dx;
+      y0 += sy;
+    }
+  }
+};
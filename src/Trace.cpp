@@ -0,0 +1,170 @@
+/*
+ */
+#include <Trace.hpp>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace pong;
+/*
+ */
+std::atomic<bool> Tracer::enabled = false;
+static std::mutex traceBuffersMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> traceBuffers;
+static const auto traceEpoch = std::chrono::steady_clock::now();
+
+void TraceBuffer::push(const TraceEvent& event)
+{
+  auto index = size.load(std::memory_order_relaxed);
+  auto& block = blocks[index / blockCapacity % blocksSize];
+  if (!block)
+  {
+    block.reset(new TraceEvent[blockCapacity]);
+  }
+  block[index % blockCapacity] = event;
+  size.store(index + 1, std::memory_order_release);
+};
+
+const TraceEvent& TraceBuffer::at(const unsigned long long& index) const
+{
+  return blocks[index / blockCapacity % blocksSize][index % blockCapacity];
+};
+
+void Tracer::enable()
+{
+  enabled.store(true, std::memory_order_relaxed);
+};
+
+unsigned long long Tracer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+};
+
+TraceBuffer& Tracer::threadBuffer()
+{
+  // registered on a thread's first event while tracing, owned by traceBuffers so events outlive the thread for
+  // export; an exited thread keeps only the blocks it filled
+  static thread_local TraceBuffer* buffer = nullptr;
+  if (!buffer)
+  {
+    std::lock_guard lock(traceBuffersMutex);
+    traceBuffers.push_back(std::make_unique<TraceBuffer>());
+    buffer = traceBuffers.back().get();
+    buffer->threadId = traceBuffers.size();
+  }
+  return *buffer;
+};
+
+void Tracer::setThreadName(const char* name)
+{
+  if (!enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  threadBuffer().threadName.store(name, std::memory_order_relaxed);
+};
+
+void Tracer::complete(const char* name, const unsigned long long& start, const unsigned long long& end)
+{
+  if (!enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  threadBuffer().push({name, 'X', start, end - start, 0});
+};
+
+void Tracer::instant(const char* name)
+{
+  if (!enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  threadBuffer().push({name, 'i', now(), 0, 0});
+};
+
+void Tracer::counter(const char* name, const long long& value)
+{
+  if (!enabled.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+  threadBuffer().push({name, 'C', now(), 0, value});
+};
+
+bool Tracer::exportChromeTrace(const std::string& filename)
+{
+  std::ofstream file(filename);
+  if (!file.is_open())
+  {
+    std::cerr << "Error: Unable to open trace file for writing.\n";
+    return false;
+  }
+  // timestamps are microseconds, fixed to the nanosecond so short spans late in a run keep their order
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() -> std::ofstream&
+  {
+    if (!first)
+    {
+      file << ",\n";
+    }
+    first = false;
+    return file;
+  };
+  std::lock_guard lock(traceBuffersMutex);
+  for (auto& buffer : traceBuffers)
+  {
+    separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+      << ",\"args\":{\"name\":\"" << buffer->threadName.load(std::memory_order_relaxed) << "\"}}";
+    auto size = buffer->size.load(std::memory_order_acquire);
+    auto firstIndex = size > TraceBuffer::capacity ? size - TraceBuffer::capacity : 0;
+    for (auto eventIndex = firstIndex; eventIndex < size; ++eventIndex)
+    {
+      auto& event = buffer->at(eventIndex);
+      auto& out = separator();
+      out << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":"
+        << buffer->threadId << ",\"ts\":" << event.timestamp / 1000.0;
+      switch (event.phase)
+      {
+      case 'X':
+        out << ",\"dur\":" << event.duration / 1000.0;
+        break;
+      case 'C':
+        out << ",\"args\":{\"value\":" << event.value << "}";
+        break;
+      case 'i':
+        out << ",\"s\":\"t\"";
+        break;
+      }
+      out << "}";
+    }
+    if (firstIndex)
+    {
+      std::cerr << "Warning: trace buffer for " << buffer->threadName.load() << " wrapped, kept the last "
+        << TraceBuffer::capacity << " of " << size << " events.\n";
+    }
+  }
+  file << "]}\n";
+  return bool(file);
+};
+
+TraceScope::TraceScope(const char* eventName):
+  name(eventName)
+{
+  if (Tracer::enabled.load(std::memory_order_relaxed))
+  {
+    start = Tracer::now();
+  }
+};
+
+TraceScope::~TraceScope()
+{
+  if (start)
+  {
+    Tracer::complete(name, start, Tracer::now());
+  }
+};
@@ -0,0 +1,193 @@
+/*
+ */
+#include <TrainingView.hpp>
+#include <Raster.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+using namespace pong;
+/*
+ */
+MatchGridEntity::MatchGridEntity(anex::IGame& gridGame, PolicyGradientTrainer& gridTrainer,
+                                 const Seqlock<TrainingStats>& trainingStats):
+  IEntity(gridGame),
+  trainer(gridTrainer),
+  stats(trainingStats),
+  tiles(gridTrainer.matches.size()),
+  columns(std::max((int)std::ceil(std::sqrt((double)gridTrainer.matches.size())), 1)),
+  rows(std::max(((int)gridTrainer.matches.size() + columns - 1) / columns, 1)),
+  tileWidth(gridGame.windowWidth / columns),
+  tileHeight((gridGame.windowHeight - headerHeight) / rows),
+  rateStart(FramePacer::Clock::now())
+{
+};
+
+void MatchGridEntity::render()
+{
+  TraceScope renderScope("MatchGridEntity::render");
+  auto &fensterGame = (FensterGame &)game;
+  if (!cleared)
+  {
+    // whatever the previous scene drew stays under tiles the budget has not reached yet
+    rasterRect(fensterGame.f, 0, 0, game.windowWidth, game.windowHeight, 0x00000000);
+    cleared = true;
+  }
+  updateRates();
+  renderHeader(fensterGame.f);
+  if (tiles.empty())
+  {
+    return;
+  }
+  auto deadline = FramePacer::Clock::now() + drawBudget;
+  unsigned long tilesDrawn = 0;
+  while (tilesDrawn < tiles.size())
+  {
+    renderTile(fensterGame.f, nextTile);
+    nextTile = (nextTile + 1) % tiles.size();
+    ++tilesDrawn;
+    if (FramePacer::Clock::now() >= deadline)
+    {
+      break;
+    }
+  }
+  Tracer::counter("Tiles drawn", tilesDrawn);
+};
+
+void MatchGridEntity::renderHeader(::fenster* f)
+{
+  stats.tryLoad(statsSample);
+  char headerText[96];
+  auto cursor = headerText;
+  auto end = headerText + sizeof(headerText) - 1;
+  auto append = [&](const char* text)
+  {
+    auto size = std::min((long)strlen(text), (long)(end - cursor));
+    memcpy(cursor, text, size);
+    cursor += size;
+  };
+  append("BATCH ");
+  cursor = std::to_chars(cursor, end, statsSample.batches).ptr;
+  append("  RETURN RATE ");
+  cursor = std::to_chars(cursor, end, statsSample.returnRate, std::chars_format::fixed, 2).ptr;
+  append("  ");
+  cursor = std::to_chars(cursor, end, (unsigned long)statsSample.stepsPerSecond).ptr;
+  append(" STEPS/S");
+  *cursor = 0;
+  rasterRect(f, 0, 0, game.windowWidth, headerHeight, 0x00000000);
+  fenster_text(f, 4, 4, headerText, 2, 0x00ffffff);
+};
+
+void MatchGridEntity::renderTile(::fenster* f, const unsigned long& tileIndex)
+{
+  auto& tile = tiles[tileIndex];
+  auto& match = *trainer.matches[tileIndex];
+  match.snapshot.tryLoad(tile.sample);
+  auto& sample = tile.sample;
+  int tileX = (tileIndex % columns) * tileWidth;
+  int tileY = headerHeight + (tileIndex / columns) * tileHeight;
+  rasterFrame(f, tileX, tileY, tileWidth, tileHeight, 1, 0x00555555);
+  rasterRect(f, tileX + 1, tileY + 1, tileWidth - 2, tileHeight - 2, 0x00000000);
+  if (sample.tick)
+  {
+    float scaleX = float(tileWidth - 2) / match.windowWidth;
+    float scaleY = float(tileHeight - 2) / match.windowHeight;
+    int batHeight = std::max(int(match.batHeight * scaleY), 1);
+    int originX = tileX + 1;
+    int originY = tileY + 1;
+    rasterRect(f, originX + int(match.leftBatX * scaleX) - 1,
+               originY + int((sample.leftBatY - match.batHeight / 2) * scaleY), 2, batHeight, 0x00ff0000);
+    rasterRect(f, originX + int(match.rightBatX * scaleX) - 1,
+               originY + int((sample.rightBatY - match.batHeight / 2) * scaleY), 2, batHeight, 0x000000ff);
+    rasterRect(f, originX + int(sample.ballX * scaleX) - 1, originY + int(sample.ballY * scaleY) - 1, 2, 2,
+               0x00ffffff);
+  }
+  if (tileWidth < textMinWidth || tileHeight < textMinHeight)
+  {
+    return;
+  }
+  char scoreText[8];
+  auto cursor = std::to_chars(scoreText, scoreText + 3, sample.leftScore).ptr;
+  *cursor++ = '-';
+  *std::to_chars(cursor, scoreText + 7, sample.rightScore).ptr = 0;
+  fenster_text(f, tileX + 4, tileY + 4, scoreText, 1, 0x00ffffff);
+  char rateText[24];
+  cursor = std::to_chars(rateText, rateText + 19, tile.ticksPerSecond).ptr;
+  memcpy(cursor, " TPS", 5);
+  fenster_text(f, tileX + 4, tileY + tileHeight - 9, rateText, 1, 0x00999999);
+};
+
+/*
+ * Ticks per second per match, from how many snapshots it stored since the last update
+ */
+void MatchGridEntity::updateRates()
+{
+  auto now = FramePacer::Clock::now();
+  std::chrono::duration<double> elapsed = now - rateStart;
+  if (elapsed < std::chrono::seconds(1))
+  {
+    return;
+  }
+  for (unsigned long tileIndex = 0; tileIndex < tiles.size(); ++tileIndex)
+  {
+    auto& tile = tiles[tileIndex];
+    auto version = trainer.matches[tileIndex]->snapshot.version();
+    tile.ticksPerSecond = (unsigned long)((version - tile.rateVersion) / elapsed.count());
+    tile.rateVersion = version;
+  }
+  rateStart = now;
+};
+
+TrainingGridScene::TrainingGridScene(anex::IGame& sceneGame, std::shared_ptr<zeuron::NeuralNetwork>& network,
+                                     std::mutex& networkMutex, ObservationNormalizer& normalizer,
+                                     const PolicyGradientSettings& settings,
+                                     const std::function<void()>& batchCallback):
+  IScene(sceneGame),
+  frameEntity(std::make_shared<FrameEntity>(sceneGame)),
+  trainer(network, networkMutex, normalizer, settings),
+  gridEntity(std::make_shared<MatchGridEntity>(sceneGame, trainer, stats)),
+  onBatch(batchCallback)
+{
+  addEntity(frameEntity);
+  addEntity(gridEntity);
+  trainingThread = std::thread(&TrainingGridScene::trainingFunction, this);
+};
+
+TrainingGridScene::~TrainingGridScene()
+{
+  trainer.stopping = true;
+  trainingThread.join();
+};
+
+void TrainingGridScene::trainingFunction()
+{
+  Tracer::setThreadName("Trainer");
+  unsigned long long steps = 0;
+  while (!trainer.stopping && game.open)
+  {
+    auto batchStart = FramePacer::Clock::now();
+    PolicyBatchStats batchStats;
+    {
+      TraceScope batchScope("Policy gradient batch");
+      batchStats = trainer.runBatch();
+    }
+    if (trainer.stopping)
+    {
+      return;
+    }
+    std::chrono::duration<double> batchSeconds = FramePacer::Clock::now() - batchStart;
+    steps += batchStats.steps;
+    // every rally ends with exactly one miss
+    auto returns = batchStats.hits + batchStats.rallies;
+    stats.store({
+      trainer.batches,
+      steps,
+      returns ? float(batchStats.hits) / returns : 0,
+      float(batchStats.steps / std::max(batchSeconds.count(), 1e-9))
+    });
+    if (onBatch)
+    {
+      onBatch();
+    }
+  }
+};
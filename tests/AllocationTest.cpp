@@ -0,0 +1,116 @@
+/*
+ * Plays headless matches between two AIControllers, the same per-tick decision AIBat runs, once with a supervised
+ * and once with a policy network. Each tick is followed by what a rendered frame does (Board, Bat and Ball
+ * stepping and drawing) into an off-screen fenster. Fails if a decision outside the network or a frame allocates
+ * once the match has warmed up.
+ */
+#include <AIController.hpp>
+#include <AINetwork.hpp>
+#include <AllocationCounter.hpp>
+#include <MatchView.hpp>
+#include <cstdio>
+#include <iostream>
+using namespace pong;
+/*
+ */
+constexpr unsigned long warmUpTicks = 1000;
+constexpr unsigned long measuredTicks = 20000;
+static uint32_t pixels[960 * 540];
+
+struct AllocationResult
+{
+  unsigned long long decisionAllocations = 0;
+  unsigned long long networkAllocations = 0;
+  unsigned long long allocatingFrames = 0;
+};
+
+AllocationResult playMatch(const bool& policyNetwork)
+{
+  const char *datasetFilename = "pong_allocation_test.pds";
+  auto network = createAINetwork();
+  std::mutex networkMutex;
+  ObservationNormalizer normalizer(ObservationNormalizer::RunningStatistics, 960, 540);
+  std::atomic<unsigned long long> generation = 0;
+  ::fenster frame{.title = "pong_allocation_test", .width = 960, .height = 540, .buf = pixels};
+  HeadlessMatch match(960, 540, 1);
+  match.publishSnapshots = true;
+  AllocationResult result;
+  {
+    auto writer = std::make_shared<DatasetWriter>(datasetFilename);
+    std::array<std::unique_ptr<AIController>, 2> controllers;
+    for (unsigned long side = 0; side < 2; ++side)
+    {
+      auto& controller = controllers[side];
+      controller = std::make_unique<AIController>(network, networkMutex, normalizer, generation,
+                                                  DecisionCache::Cache, side + 1);
+      controller->leftSide = side == 0;
+      controller->batX = side == 0 ? match.leftBatX : match.rightBatX;
+      controller->batHeight = match.batHeight;
+      controller->policyNetwork = policyNetwork;
+      controller->datasetRecorder = std::make_unique<DatasetRecorder>(writer);
+    }
+    auto& left = *controllers[0];
+    auto& right = *controllers[1];
+    AllocationScope decisionScope;
+    AllocationScope frameScope;
+    for (unsigned long tick = 0; tick < warmUpTicks + measuredTicks; ++tick)
+    {
+      auto networkAllocations = left.networkAllocations + right.networkAllocations;
+      decisionScope.reset();
+      auto snapshot = match.snapshot.load();
+      match.leftBatVelocityY = left.decide(snapshot);
+      match.rightBatVelocityY = right.decide(snapshot);
+      auto tickNetworkAllocations = left.networkAllocations + right.networkAllocations - networkAllocations;
+      auto decisionAllocations = decisionScope.threadAllocations() - tickNetworkAllocations;
+      // Board::render's frameAllocationScope covers the same stepping and drawing
+      frameScope.reset();
+      match.step();
+      drawBoard(&frame, match.windowWidth, match.windowHeight, match.state.leftScore, match.state.rightScore);
+      drawBat(&frame, match.leftBatX, match.state.leftBatY, match.batHeight, 0x00ff0000);
+      drawBat(&frame, match.rightBatX, match.state.rightBatY, match.batHeight, 0x000000ff);
+      drawBall(&frame, match.state.ballX, match.state.ballY, 4, match.bounces);
+      auto frameAllocations = frameScope.threadAllocations();
+      if (tick < warmUpTicks)
+      {
+        continue;
+      }
+      result.decisionAllocations += decisionAllocations;
+      result.networkAllocations += tickNetworkAllocations;
+      result.allocatingFrames += frameAllocations != 0;
+    }
+  }
+  std::remove(datasetFilename);
+  return result;
+};
+
+int main()
+{
+  bool failed = false;
+  for (auto policyNetwork : {false, true})
+  {
+    auto networkName = policyNetwork ? "policy network" : "supervised network";
+    auto result = playMatch(policyNetwork);
+    // zeuron's feedforward and backpropagate are outside pong's control, they are reported rather than asserted
+    std::cout << networkName << ": network allocations over " << measuredTicks << " ticks: "
+      << result.networkAllocations << std::endl;
+    if (result.decisionAllocations)
+    {
+      std::cerr << "Error: " << networkName << ": " << result.decisionAllocations << " allocations outside the "
+        "network over " << measuredTicks << " ticks after warm-up.\n";
+      failed = true;
+    }
+    if (result.allocatingFrames)
+    {
+      std::cerr << "Error: " << networkName << ": " << result.allocatingFrames << " of " << measuredTicks
+        << " frames allocated after warm-up.\n";
+      failed = true;
+    }
+  }
+  if (failed)
+  {
+    return 1;
+  }
+  std::cout << "no allocations outside the network and none per frame over " << measuredTicks
+    << " ticks after warm-up" << std::endl;
+  return 0;
+};
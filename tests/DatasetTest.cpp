@@ -0,0 +1,93 @@
+/*
+ * Records rallies through DatasetRecorder, reads the file back with MappedDataset and checks every column,
+ * including the outcome stamped by endRally and the unknown (0) outcome of rallies cut by a chunk or the end
+ */
+#include <Dataset.hpp>
+#include <cstdio>
+#include <iostream>
+using namespace pong;
+/*
+ */
+constexpr unsigned long recordsSize = 10000;
+constexpr unsigned long rallySize = 150;
+
+int8_t expectedOutcome(const unsigned long& recordIndex)
+{
+  auto rally = recordIndex / rallySize;
+  auto rallyEnd = (rally + 1) * rallySize;
+  if (rallyEnd > recordsSize || (rallyEnd - 1) / DatasetChunk::capacity != recordIndex / DatasetChunk::capacity)
+  {
+    return 0;
+  }
+  return rally % 2 ? -1 : 1;
+};
+
+int main()
+{
+  const char *datasetFilename = "pong_dataset_test.pds";
+  unsigned long long droppedRecords;
+  {
+    auto writer = std::make_shared<DatasetWriter>(datasetFilename);
+    {
+      DatasetRecorder recorder(writer);
+      std::vector<long double> observation(DatasetFormat::observationWidth);
+      std::vector<long double> expectedOutputs(DatasetFormat::expectedWidth);
+      for (unsigned long recordIndex = 0; recordIndex < recordsSize; ++recordIndex)
+      {
+        for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+        {
+          observation[column] = recordIndex * 0.25 + column;
+        }
+        expectedOutputs[0] = recordIndex % 3 == 0;
+        expectedOutputs[1] = recordIndex % 3 == 1;
+        recorder.record(observation, expectedOutputs);
+        if ((recordIndex + 1) % rallySize == 0)
+        {
+          recorder.endRally(expectedOutcome(recordIndex));
+        }
+      }
+    }
+    writer->close();
+    droppedRecords = writer->droppedRecords;
+  }
+  unsigned long errors = 0;
+  auto check = [&](const bool& passed, const char* what, const unsigned long& recordIndex)
+  {
+    if (!passed && ++errors <= 10)
+    {
+      std::cerr << "Error: " << what << " of record " << recordIndex << " did not round-trip.\n";
+    }
+  };
+  try
+  {
+    MappedDataset dataset(datasetFilename);
+    check(dataset.recordsSize == recordsSize && !droppedRecords, "count", recordsSize);
+    unsigned long recordIndex = 0;
+    for (auto& chunk : dataset.chunks)
+    {
+      for (unsigned long index = 0; index < chunk.size; ++index, ++recordIndex)
+      {
+        for (unsigned long column = 0; column < DatasetFormat::observationWidth; ++column)
+        {
+          check(chunk.observations[column][index] == float(recordIndex * 0.25 + column), "observation",
+                recordIndex);
+        }
+        check(chunk.expectedOutputs[0][index] == float(recordIndex % 3 == 0), "expected output", recordIndex);
+        check(chunk.expectedOutputs[1][index] == float(recordIndex % 3 == 1), "expected output", recordIndex);
+        check(chunk.outcomes[index] == expectedOutcome(recordIndex), "outcome", recordIndex);
+      }
+    }
+  }
+  catch (const std::exception& exception)
+  {
+    std::cerr << exception.what() << "\n";
+    ++errors;
+  }
+  std::remove(datasetFilename);
+  if (errors)
+  {
+    return 1;
+  }
+  std::cout << recordsSize << " records round-tripped with their outcomes" << std::endl;
+  return 0;
+};
@@ -0,0 +1,153 @@
+/*
+ * Checks the DecisionCache lookup rules, that cache hits replay the action a frozen supervised network would have
+ * chosen, and that a supervised AIController skips inference (and its backprop) on cache hits
+ */
+#include <AIController.hpp>
+#include <AINetwork.hpp>
+#include <iostream>
+using namespace pong;
+/*
+ */
+constexpr unsigned long trainingTicks = 20000;
+constexpr unsigned long matchTicks = 20000;
+
+unsigned long errors = 0;
+
+void check(const bool& passed, const char* what)
+{
+  if (!passed)
+  {
+    std::cerr << "Error: " << what << ".\n";
+    ++errors;
+  }
+};
+
+void checkLookups()
+{
+  std::array<long double, 2> outputs{0.25, 0.75};
+  std::array<long double, 2> found{};
+  auto key = DecisionCache::makeKey(12, 200, 300, 480, 270, -4, 3, 1);
+  check(key != DecisionCache::makeKey(12, 200, 300, 480, 270, -4, 3, 2), "keys with different labels are equal");
+  check(key != DecisionCache::makeKey(12, 200, 300, 400, 270, -4, 3, 1), "keys with different ball x are equal");
+  check(key == DecisionCache::makeKey(13, 201, 301, 481, 271, -4, 3.2, 1), "keys in the same buckets differ");
+  DecisionCache cache(DecisionCache::Cache, 4);
+  check(!cache.lookup(key, 0, found), "an empty cache hit");
+  cache.store(key, 10, outputs);
+  check(cache.lookup(key, 14, found) && found == outputs, "a fresh entry missed");
+  check(!cache.lookup(key, 15, found), "an entry older than maxAge hit");
+  DecisionCache onChange(DecisionCache::OnChange);
+  onChange.store(key, 0, outputs);
+  check(onChange.lookup(key, 0, found), "OnChange missed its last key");
+  onChange.store(key + 1, 0, outputs);
+  check(!onChange.lookup(key, 0, found), "OnChange hit a key it no longer holds");
+  DecisionCache off(DecisionCache::Off);
+  off.store(key, 0, outputs);
+  check(!off.lookup(key, 0, found), "Off hit");
+};
+
+/*
+ * The key leaves out the distance to the ball and the ball position, which the network does see. Trains a
+ * supervised network without the cache, freezes it and checks that the action a cache hit replays matches the one
+ * a fresh forward pass over the current observation chooses.
+ */
+void checkHitActions()
+{
+  auto network = createAINetwork();
+  std::mutex networkMutex;
+  ObservationNormalizer normalizer(ObservationNormalizer::RunningStatistics, 960, 540);
+  std::atomic<unsigned long long> generation = 0;
+  HeadlessMatch match(960, 540, 1);
+  std::array<std::unique_ptr<AIController>, 2> controllers;
+  for (unsigned long side = 0; side < 2; ++side)
+  {
+    auto& controller = controllers[side];
+    controller = std::make_unique<AIController>(network, networkMutex, normalizer, generation, DecisionCache::Off,
+                                                side + 1);
+    controller->leftSide = side == 0;
+    controller->batX = side == 0 ? match.leftBatX : match.rightBatX;
+    controller->batHeight = match.batHeight;
+  }
+  for (unsigned long tick = 0; tick < trainingTicks; ++tick)
+  {
+    match.leftBatVelocityY = controllers[0]->decide(match.state);
+    match.rightBatVelocityY = controllers[1]->decide(match.state);
+    match.step();
+  }
+  std::array<DecisionCache, 2> caches{DecisionCache(DecisionCache::Cache), DecisionCache(DecisionCache::Cache)};
+  unsigned long long mismatches = 0;
+  for (unsigned long tick = 0; tick < matchTicks; ++tick)
+  {
+    for (unsigned long side = 0; side < 2; ++side)
+    {
+      auto& controller = *controllers[side];
+      auto& input = controller.input;
+      auto batY = controller.leftSide ? match.state.leftBatY : match.state.rightBatY;
+      observeMatch(match.state, controller.leftSide, controller.batX, controller.batHeight, input);
+      auto label = labelMatch(match.state, controller.leftSide, controller.expectedOutputs);
+      auto key = DecisionCache::makeKey(match.state.hitPoint.x, match.state.hitPoint.y, batY, match.state.ballX,
+                                        match.state.ballY, match.state.ballVelocityX, match.state.ballVelocityY,
+                                        label);
+      normalizer.normalize(input);
+      network->feedforward(input);
+      const auto& outputs = network->getOutputs();
+      controller.decisionOutputs = {outputs[0], outputs[1]};
+      auto velocityY = controller.applyOutputs();
+      std::array<long double, 2> cachedOutputs;
+      // the network is frozen, so every entry stays the same generation
+      if (caches[side].lookup(key, 0, cachedOutputs))
+      {
+        controller.decisionOutputs = cachedOutputs;
+        mismatches += controller.applyOutputs() != velocityY;
+      }
+      else
+      {
+        caches[side].store(key, 0, controller.decisionOutputs);
+      }
+      (controller.leftSide ? match.leftBatVelocityY : match.rightBatVelocityY) = velocityY;
+    }
+    match.step();
+  }
+  auto hits = caches[0].hits + caches[1].hits;
+  check(hits, "the cache never hit");
+  check(mismatches * 100 <= hits, "more than 1% of cache hits replayed a different action");
+  std::cout << "frozen supervised network: " << mismatches << " of " << hits << " cache hits over "
+    << 2 * matchTicks << " decisions replayed a different action" << std::endl;
+};
+
+void checkSupervisedHits()
+{
+  auto network = createAINetwork();
+  std::mutex networkMutex;
+  ObservationNormalizer normalizer(ObservationNormalizer::RunningStatistics, 960, 540);
+  std::atomic<unsigned long long> generation = 0;
+  HeadlessMatch match(960, 540, 2);
+  AIController left(network, networkMutex, normalizer, generation, DecisionCache::Cache, 1);
+  AIController right(network, networkMutex, normalizer, generation, DecisionCache::Cache, 2);
+  right.leftSide = false;
+  for (auto controller : {&left, &right})
+  {
+    controller->batX = controller->leftSide ? match.leftBatX : match.rightBatX;
+    controller->batHeight = match.batHeight;
+  }
+  for (unsigned long tick = 0; tick < matchTicks; ++tick)
+  {
+    match.leftBatVelocityY = left.decide(match.state);
+    match.rightBatVelocityY = right.decide(match.state);
+    match.step();
+  }
+  auto hits = left.decisionCache.hits + right.decisionCache.hits;
+  auto inferences = left.inferenceCount + right.inferenceCount;
+  check(hits && hits + inferences == 2 * matchTicks, "a supervised controller did not use the cache");
+  // every inference of a supervised network is followed by one backprop, which bumps the generation
+  check(generation == inferences, "a supervised controller backpropagated a cache hit");
+  std::cout << "supervised: " << inferences << " inferences and " << hits << " cache hits over "
+    << 2 * matchTicks << " decisions" << std::endl;
+};
+
+int main()
+{
+  checkLookups();
+  checkHitActions();
+  checkSupervisedHits();
+  return errors ? 1 : 0;
+};